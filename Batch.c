@@ -0,0 +1,284 @@
+/*******************************************************************************
+ * File: StCore\Batch.c
+ * Author: agent
+ * Date: 2026-10-17
+*******************************************************************************/
+
+#include "Main.h"
+#define LOG_OBJECT "Batch"
+
+/* Prototypes */
+static long logMessage(coreLogSeverityEnum severity, unsigned short code, char *message, coreFormatArgumentType *args);
+static void rejectRemaining(signed long *pResults, unsigned short count);
+
+/* Submit an array of commands at once, returns the number of commands submitted or a negative status */
+long StCoreCommandBatch(StCoreCommandType *pCommands, unsigned short Count, unsigned char Mode, signed long *pResults) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.pCommandBuffer
+	   core.commandPool
+	   core.error
+	   core.statusID
+	  Subroutines:
+	   logMessage
+	   coreCommandBuild
+	   rejectRemaining
+	   coreCommandReserve
+	   coreCommandUnreserve
+	   coreCommandPublish
+	   coreCommandHandle
+	************************************************/
+	
+	/***********************
+	 Declare Local Variables
+	***********************/
+	SuperTrakCommand_t data[CORE_COMMAND_BATCH_MAX];
+	coreCommandType *pCommand[CORE_COMMAND_BATCH_MAX];
+	unsigned char index[CORE_COMMAND_BATCH_MAX];
+	signed long result[CORE_COMMAND_BATCH_MAX];
+	coreFormatArgumentType args;
+	unsigned short i, j, accepted;
+	long status, firstStatus;
+	
+	/**********
+	 Check Core
+	**********/
+	/* Check cyclic core */
+	if(core.error) {
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(core.statusID), "Command batch aborted due to critical error in StCore", NULL);
+		return core.statusID;
+	}
+	
+	/* Check reference */
+	if(core.pCommandBuffer == NULL) {
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_ALLOCATION), "Command batch cannot reference command buffer", NULL);
+		return stCORE_ERROR_ALLOCATION;
+	}
+	
+	/* Check inputs */
+	if(pCommands == NULL || Count == 0 || Count > CORE_COMMAND_BATCH_MAX || Mode > stCORE_BATCH_BEST_EFFORT) {
+		args.i[0] = Count;
+		args.i[1] = CORE_COMMAND_BATCH_MAX;
+		args.i[2] = Mode;
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_BATCH), "Command batch of %i commands exceeds limits [1, %i] or mode %i is invalid", &args);
+		return stCORE_ERROR_BATCH;
+	}
+	
+	/****************
+	 Validate Entries
+	****************/
+	/* Build every command before any reservation so an all-or-nothing batch fails without side effects */
+	firstStatus = 0;
+	for(i = 0; i < Count; i++) {
+		result[i] = coreCommandBuild(pCommands + i, &index[i], &data[i]);
+		pCommand[i] = NULL;
+		if(result[i] && firstStatus == 0)
+			firstStatus = result[i];
+	}
+	
+	if(firstStatus && Mode == stCORE_BATCH_ALL_OR_NOTHING) {
+		for(i = 0; i < Count; i++) {
+			if(result[i] == 0)
+				result[i] = stCORE_WARNING_BATCH;
+		}
+		if(pResults != NULL)
+			memcpy(pResults, result, sizeof(result[0]) * Count);
+		return firstStatus;
+	}
+	
+	/****************
+	 Reserve Commands
+	****************/
+	for(i = 0; i < Count; i++) {
+		if(result[i])
+			continue;
+		
+		status = coreCommandReserve(index[i], &pCommand[i], NULL);
+		if(status == 0)
+			continue;
+		
+		result[i] = status;
+		args.i[0] = i;
+		args.i[1] = index[i];
+		args.i[2] = (long)core.commandPool.used;
+		args.i[3] = (long)core.commandPool.size;
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(status), "Command batch entry %i for pallet %i rejected because buffer is full (%i of %i pooled commands in use)", &args);
+		
+		/* Return every reservation so far and report the rest as not submitted */
+		if(Mode == stCORE_BATCH_ALL_OR_NOTHING) {
+			for(j = 0; j < i; j++) {
+				coreCommandUnreserve(index[j], pCommand[j]);
+				result[j] = stCORE_WARNING_BATCH;
+			}
+			rejectRemaining(result + i + 1, Count - i - 1);
+			if(pResults != NULL)
+				memcpy(pResults, result, sizeof(result[0]) * Count);
+			return status;
+		}
+	}
+	
+	/****************
+	 Publish Commands
+	****************/
+	/* Entries are published in array order so commands to the same pallet keep their order */
+	accepted = 0;
+	for(i = 0; i < Count; i++) {
+		if(pCommand[i] == NULL)
+			continue;
+		result[i] = (signed long)coreCommandHandle(pCommand[i]);
+		coreCommandPublish(index[i], pCommand[i], &data[i], NULL);
+		accepted++;
+	}
+	
+	if(pResults != NULL)
+		memcpy(pResults, result, sizeof(result[0]) * Count);
+	
+	/* One confirmation message per batch */
+	args.i[0] = accepted;
+	args.i[1] = Count;
+	if(accepted < Count)
+		logMessage(CORE_LOG_SEVERITY_WARNING, coreLogCode(stCORE_WARNING_BATCH_PARTIAL), "Command batch request of %i of %i commands, see the result of each command", &args);
+	else
+		logMessage(CORE_LOG_SEVERITY_DEBUG, 4200, "Command batch request of %i of %i commands", &args);
+	
+	return accepted;
+	
+} /* End function */
+
+/* Submit a batch of commands on rising edge of Execute */
+void StCoreBatch(StCoreBatch_typ *inst) {
+	
+	/************************************************
+	 Dependencies:
+	  Subroutines:
+	   StCoreCommandBatch
+	************************************************/
+	
+	/* Declare local variables */
+	long status;
+	
+	if(inst->Execute && !GET_BIT(inst->Internal.PreviousCommand, 0)) {
+		status = StCoreCommandBatch(inst->pCommands, inst->Count, inst->Mode, inst->pResults);
+		if(status < 0) {
+			inst->Done = false;
+			inst->Error = true;
+			inst->StatusID = status;
+			inst->Accepted = 0;
+		}
+		else {
+			inst->Done = true;
+			inst->Error = false;
+			inst->StatusID = status < inst->Count ? stCORE_WARNING_BATCH_PARTIAL : 0;
+			inst->Accepted = (unsigned short)status;
+		}
+	}
+	else if(!inst->Execute) {
+		inst->Done = false;
+		inst->Error = false;
+		inst->StatusID = 0;
+		inst->Accepted = 0;
+	}
+	
+	coreAssign16(&inst->Internal.PreviousCommand, 0, inst->Execute);
+	
+} /* End function */
+
+/* Derive command ID and context and pack the command data of one batch or replacement entry */
+long coreCommandBuild(StCoreCommandType *pEntry, unsigned char *pIndex, SuperTrakCommand_t *pData) {
+	
+	/************************************************
+	 Dependencies:
+	  Subroutines:
+	   coreCommandCreate
+	   coreCommandPack
+	   logMessage
+	************************************************/
+	
+	/* Declare local variables */
+	StCoreTargetParameterType *pParameters = &pEntry->Parameters;
+	coreCommandCreateType create;
+	coreFormatArgumentType args;
+	unsigned char start, pallet, value;
+	unsigned short direction;
+	double first, second;
+	long status;
+	
+	/* Select command ID and its parameters */
+	direction = 0;
+	pallet = pEntry->Pallet;
+	value = 0;
+	first = 0.0;
+	second = 0.0;
+	switch(pEntry->Command) {
+		case stCORE_COMMAND_RELEASE:
+			start = CORE_COMMAND_ID_RELEASE;
+			direction = pParameters->Release.Direction;
+			value = pParameters->Release.DestinationTarget;
+			break;
+		case stCORE_COMMAND_OFFSET:
+			start = CORE_COMMAND_ID_OFFSET;
+			direction = pParameters->Release.Direction;
+			value = pParameters->Release.DestinationTarget;
+			first = pParameters->Release.Offset;
+			break;
+		case stCORE_COMMAND_INCREMENT:
+			start = CORE_COMMAND_ID_INCREMENT;
+			first = pParameters->Release.Offset;
+			break;
+		case stCORE_COMMAND_CONTINUE:
+			start = CORE_COMMAND_ID_CONTINUE;
+			break;
+		case stCORE_COMMAND_PALLET_ID:
+			start = CORE_COMMAND_ID_PALLET_ID;
+			pallet = 0;
+			value = pParameters->PalletID;
+			break;
+		case stCORE_COMMAND_MOTION:
+			start = CORE_COMMAND_ID_MOTION;
+			first = pParameters->Motion.Velocity;
+			second = pParameters->Motion.Acceleration;
+			break;
+		case stCORE_COMMAND_MECHANICAL:
+			start = CORE_COMMAND_ID_MECHANICAL;
+			first = pParameters->Mechanical.ShelfWidth;
+			second = pParameters->Mechanical.CenterOffset;
+			break;
+		case stCORE_COMMAND_CONTROL:
+			start = CORE_COMMAND_ID_CONTROL;
+			value = pParameters->Control.ControlGainSet;
+			first = pParameters->Control.MovingFilter;
+			second = pParameters->Control.StationaryFilter;
+			break;
+		default:
+			args.i[0] = pEntry->Command;
+			logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_BATCH), "Command entry with unknown command %i", &args);
+			return stCORE_ERROR_BATCH;
+	}
+	
+	/* Get command assignment */
+	status = coreCommandCreate(start, pEntry->Target, pallet, direction, &create);
+	if(status)
+		return status;
+	
+	/* Create command, packed the same as the individual command functions */
+	coreCommandPack(start, &create, value, first, second, pData);
+	
+	*pIndex = create.index;
+	
+	return 0;
+	
+} /* End function */
+
+/* Mark entries that were not attempted */
+void rejectRemaining(signed long *pResults, unsigned short count) {
+	unsigned short i;
+	for(i = 0; i < count; i++)
+		pResults[i] = stCORE_WARNING_BATCH;
+}
+
+/* Create local logging function */
+long logMessage(coreLogSeverityEnum severity, unsigned short code, char *message, coreFormatArgumentType *args) {
+	return coreLog(core.ident, severity, CORE_LOGBOOK_FACILITY, code, LOG_OBJECT, message, args);
+}
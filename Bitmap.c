@@ -0,0 +1,42 @@
+/*******************************************************************************
+ * File: StCore\Bitmap.c
+ * Author: agent
+ * Date: 2026-10-17
+*******************************************************************************/
+
+#include "Main.h"
+
+/* Find the next set bit at or after start, wrapping to the beginning, -1 if none are set */
+long coreBitmapFind(unsigned long *pBitmap, unsigned long count, unsigned long start) {
+	
+	/* Declare local variables */
+	unsigned long word, index, i, wordCount;
+	
+	/* Guard inputs */
+	if(pBitmap == NULL || count == 0)
+		return -1;
+	if(start >= count)
+		start = 0;
+	
+	wordCount = BITMAP_WORDS(count);
+	index = start / CORE_BITMAP_WORD_BITS;
+	
+	/* Mask bits below start in the first word */
+	word = pBitmap[index] & (~0UL << (start % CORE_BITMAP_WORD_BITS));
+	
+	/* Visit each word once, then the first word again for bits below start */
+	for(i = 0; i <= wordCount; i++) {
+		if(i == wordCount)
+			word = pBitmap[index] & ~(~0UL << (start % CORE_BITMAP_WORD_BITS));
+		if(word) {
+			word = index * CORE_BITMAP_WORD_BITS + COUNT_TRAILING_ZEROS(word);
+			if(word < count)
+				return (long)word;
+		}
+		index = (index + 1) % wordCount;
+		word = pBitmap[index];
+	}
+	
+	return -1;
+	
+} /* End function */
@@ -0,0 +1,156 @@
+/*******************************************************************************
+ * File: StCore\Cancel.c
+ * Author: agent
+ * Date: 2026-10-17
+*******************************************************************************/
+
+#include "Main.h"
+#define LOG_OBJECT "Cancel"
+
+/* Prototypes */
+static long logMessage(coreLogSeverityEnum severity, unsigned short code, char *message, coreFormatArgumentType *args);
+
+/* Withdraw a pending command before it is sent */
+long StCoreCancelCommand(unsigned long Handle) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.commandPool
+	   core.pSimpleRelease
+	   core.targetCount
+	  Subroutines:
+	   logMessage
+	   coreCommandSlot
+	************************************************/
+	
+	/* Declare local variables */
+	coreCommandType *pCommand;
+	coreFormatArgumentType args;
+	
+	/* Check references */
+	if(core.commandPool.pNode == NULL || core.pSimpleRelease == NULL)
+		return stCORE_ERROR_ALLOCATION;
+	
+	pCommand = coreCommandSlot(Handle);
+	if(pCommand == NULL) {
+		args.i[0] = (long)Handle;
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_HANDLE), "Cancel command handle %i is invalid", &args);
+		return stCORE_ERROR_HANDLE;
+	}
+	
+	/* Take the claim of this use of the command, the command manager takes it the same way before it is sent */
+	if(!__sync_bool_compare_and_swap(&pCommand->claim, Handle, 0)) {
+		args.i[0] = (long)Handle;
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_CANCEL), "Cancel command handle %i rejected because the command is no longer pending", &args);
+		return stCORE_ERROR_CANCEL;
+	}
+	
+	/* A simple release is reusable once done, the command manager reports its cancellation first and then marks it done */
+	if(core.pSimpleRelease <= pCommand && pCommand < core.pSimpleRelease + core.targetCount)
+		pCommand->status = 1U << CORE_COMMAND_CANCELLED;
+	/* The command manager reports and removes the command when it reaches the front of the pallet queue */
+	else
+		pCommand->status = 1U << CORE_COMMAND_DONE | 1U << CORE_COMMAND_CANCELLED;
+	
+	args.i[0] = (long)Handle;
+	logMessage(CORE_LOG_SEVERITY_DEBUG, 4200, "Command handle %i cancelled", &args);
+	
+	return 0;
+	
+} /* End function */
+
+/* Replace a pending command in place, returns the command handle or a negative status */
+long StCoreReplaceCommand(unsigned long Handle, StCoreCommandType *pReplacement) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.commandPool
+	   core.pSimpleRelease
+	   core.error
+	   core.statusID
+	  Subroutines:
+	   logMessage
+	   coreCommandSlot
+	   coreCommandBuild
+	************************************************/
+	
+	/* Declare local variables */
+	coreCommandType *pCommand;
+	SuperTrakCommand_t data;
+	coreFormatArgumentType args;
+	unsigned char index;
+	long status;
+	
+	/* Check cyclic core */
+	if(core.error)
+		return core.statusID;
+	
+	/* Check references */
+	if(core.commandPool.pNode == NULL || core.pSimpleRelease == NULL || pReplacement == NULL)
+		return stCORE_ERROR_ALLOCATION;
+	
+	pCommand = coreCommandSlot(Handle);
+	if(pCommand == NULL) {
+		args.i[0] = (long)Handle;
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_HANDLE), "Replace command handle %i is invalid", &args);
+		return stCORE_ERROR_HANDLE;
+	}
+	
+	/* Build the replacement before taking the command so an invalid replacement leaves it untouched */
+	status = coreCommandBuild(pReplacement, &index, &data);
+	if(status)
+		return status;
+	
+	/* Simple releases have no pallet queue, a replacement must stay in the same pallet queue to keep its place */
+	if(core.pSimpleRelease <= pCommand && pCommand < core.pSimpleRelease + core.targetCount) {
+		args.i[0] = (long)Handle;
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_CANCEL), "Replace command handle %i rejected because simple target releases cannot be replaced", &args);
+		return stCORE_ERROR_CANCEL;
+	}
+	if(index != pCommand->index) {
+		args.i[0] = (long)Handle;
+		args.i[1] = pCommand->index;
+		args.i[2] = index;
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_CANCEL), "Replace command handle %i rejected because pallet buffer %i differs from replacement pallet buffer %i", &args);
+		return stCORE_ERROR_CANCEL;
+	}
+	
+	/* Take the claim, the command manager skips the command until it is returned */
+	if(!__sync_bool_compare_and_swap(&pCommand->claim, Handle, 0)) {
+		args.i[0] = (long)Handle;
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_CANCEL), "Replace command handle %i rejected because the command is no longer pending", &args);
+		return stCORE_ERROR_CANCEL;
+	}
+	
+	/* Write the replacement, the command keeps its place in the queue and its handle */
+	memcpy(&pCommand->command, &data, sizeof(pCommand->command));
+	pCommand->attempt = 0;
+	__sync_synchronize(); /* Return the claim after the command is written */
+	pCommand->claim = Handle;
+	
+	args.i[0] = (long)Handle;
+	logMessage(CORE_LOG_SEVERITY_DEBUG, 4200, "Command handle %i replaced", &args);
+	
+	return (long)Handle;
+	
+} /* End function */
+
+/* Take the claim of a pending command to send it, returns false if the command is cancelled or being replaced */
+unsigned char coreCommandTake(coreCommandType *pCommand) {
+	
+	/* Declare local variables */
+	unsigned long claim;
+	
+	claim = pCommand->claim;
+	if(claim == 0)
+		return false;
+	
+	return __sync_bool_compare_and_swap(&pCommand->claim, claim, 0);
+}
+
+/* Create local logging function */
+long logMessage(coreLogSeverityEnum severity, unsigned short code, char *message, coreFormatArgumentType *args) {
+	return coreLog(core.ident, severity, CORE_LOGBOOK_FACILITY, code, LOG_OBJECT, message, args);
+}
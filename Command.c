@@ -13,6 +13,11 @@ static void getCommand(char *str, unsigned long size, SuperTrakCommand_t data);
 static void getContext(char *str, unsigned long size, SuperTrakCommand_t data);
 static void getDirection(char *str, unsigned long size, SuperTrakCommand_t data);
 static void getParameter(char *str, unsigned long size, SuperTrakCommand_t data);
+static void takeInbox(coreCommandBufferType *pBuffer);
+static void coalesceCommand(coreCommandBufferType *pBuffer, coreCommandType *pCommand);
+static void dequeueCommand(coreCommandBufferType *pBuffer);
+static long assignChannel(coreCommandBufferType *pBuffer, coreCommandType *pCommand);
+static unsigned char urgentCommand(coreCommandBufferType *pBuffer, coreCommandType *pCommand);
 
 /* Create command ID, context, and buffer assignment */
 long coreCommandCreate(unsigned char start, unsigned char target, unsigned char pallet, unsigned short direction, coreCommandCreateType *create) {
@@ -49,17 +54,18 @@ long coreCommandCreate(unsigned char start, unsigned char target, unsigned char
 	/**********
 	 Check Core
 	**********/
-	data.u1[0] = create->commandID;
-	getCommand(args.s[0], sizeof(args.s[0]), data);
+	data.u1[0] = create->commandID; /* Command name is only formatted when logged */
 	
 	/* Check cyclic core */
 	if(core.error) {
+		getCommand(args.s[0], sizeof(args.s[0]), data);
 		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(core.statusID), "%s command assignment aborted due to critical error in StCore", &args);
 		return core.statusID;
 	}
 	
 	/* Check reference */
 	if(core.pCyclicStatus == NULL) {
+		getCommand(args.s[0], sizeof(args.s[0]), data);
 		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_ALLOCATION), "%s command assignment cannot reference cyclic data", &args);
 		return stCORE_ERROR_ALLOCATION;
 	}
@@ -71,6 +77,7 @@ long coreCommandCreate(unsigned char start, unsigned char target, unsigned char
 		if(target > core.targetCount) {
 			args.i[0] = target;
 			args.i[1] = core.targetCount;
+			getCommand(args.s[0], sizeof(args.s[0]), data);
 			logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_CONTEXT), "%s command's target %i context exceeds limits [1, %i]", &args);
 			return stCORE_ERROR_CONTEXT;
 		}
@@ -80,6 +87,7 @@ long coreCommandCreate(unsigned char start, unsigned char target, unsigned char
 			args.i[0] = target;
 			args.i[1] = *pPalletPresent;
 			args.i[2] = core.palletCount;
+			getCommand(args.s[0], sizeof(args.s[0]), data);
 			logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_CONTEXT), "%s command's target %i context with pallet %i present exceeding limits [1, %i]", &args);
 			return stCORE_ERROR_CONTEXT;
 		}
@@ -91,6 +99,7 @@ long coreCommandCreate(unsigned char start, unsigned char target, unsigned char
 		if(pallet < 1 || core.palletCount < pallet) {
 			args.i[0] = pallet;
 			args.i[1] = core.palletCount;
+			getCommand(args.s[0], sizeof(args.s[0]), data);
 			logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_CONTEXT), "%s command's pallet %i context exceeds limits [1, %i]", &args);
 			return stCORE_ERROR_CONTEXT;
 		}
@@ -103,40 +112,113 @@ long coreCommandCreate(unsigned char start, unsigned char target, unsigned char
 	
 } /* End function */
 
+/* Pack command data, the one encoding of each command shared by individual, batch, and group requests */
+void coreCommandPack(unsigned char start, coreCommandCreateType *create, unsigned char value, double first, double second, SuperTrakCommand_t *pData) {
+	
+	/* Declare local variables */
+	unsigned short word;
+	long offset;
+	
+	memset(pData, 0, sizeof(*pData));
+	pData->u1[0] = create->commandID;
+	pData->u1[1] = create->context;
+	
+	/* Value is the destination target, pallet ID, or control gain set, first and second are the command's parameters */
+	switch(start) {
+		case CORE_COMMAND_ID_RELEASE:
+			pData->u1[2] = value;
+			break;
+		
+		case CORE_COMMAND_ID_OFFSET:
+			pData->u1[2] = value;
+			offset = (long)(first * 1000.0); /* mm to um */
+			memcpy(&pData->u1[4], &offset, 4);
+			break;
+		
+		case CORE_COMMAND_ID_INCREMENT:
+			offset = (long)(first * 1000.0); /* mm to um */
+			memcpy(&pData->u1[4], &offset, 4);
+			break;
+		
+		case CORE_COMMAND_ID_PALLET_ID:
+			pData->u1[2] = value;
+			break;
+		
+		case CORE_COMMAND_ID_MOTION:
+			word = (unsigned short)first;
+			memcpy(&pData->u1[2], &word, 2);
+			word = (unsigned short)(second / 1000.0);
+			memcpy(&pData->u1[4], &word, 2);
+			break;
+		
+		case CORE_COMMAND_ID_MECHANICAL:
+			word = (unsigned short)(first * 10.0); /* Units of 0.1 mm */
+			memcpy(&pData->u1[2], &word, 2);
+			word = (unsigned short)(second * 10.0); /* Units of 0.1 mm */
+			memcpy(&pData->u1[4], &word, 2);
+			break;
+		
+		case CORE_COMMAND_ID_CONTROL:
+			pData->u1[2] = value;
+			pData->u1[3] = (unsigned char)(fmax(0.0, fmin(99.0, first * 100.0)));
+			pData->u1[4] = (unsigned char)(fmax(0.0, fmin(99.0, second * 100.0)));
+			break;
+		
+		default:
+			break; /* Continue has no parameters */
+	}
+	
+} /* End function */
+
+/* Format the context, context number, and name of a command for "%s %i %s command" messages */
+void coreCommandDescribe(SuperTrakCommand_t data, coreFormatArgumentType *args) {
+	getContext(args->s[0], sizeof(args->s[0]), data);
+	args->i[0] = data.u1[1];
+	getCommand(args->s[1], sizeof(args->s[1]), data);
+}
+
 /* Add command to pallet buffer */
-long coreCommandRequest(unsigned char index, SuperTrakCommand_t command, void *pInstance, coreCommandType **ppCommand) {
+long coreCommandRequest(unsigned char index, SuperTrakCommand_t command, void *pInstance, unsigned long *pHandle) {
 	
 	/************************************************
 	 Dependencies:
 	  Global:
-	   core.pCommandBuffer (rw)
+	   core.pCommandBuffer
+	   core.commandPool
+	   core.debug
 	   core.error
 	   core.statusID
 	  Subroutines:
+	   getCommand
+	   getContext
 	   getParameter
 	   logMessage
+	   coreCommandReserve
+	   coreCommandPublish
+	   coreCommandHandle
 	************************************************/
 	
 	/***********************
 	 Declare Local Variables
 	***********************/
-	coreCommandBufferType *pBuffer;
 	coreCommandType *pCommand;
 	coreFormatArgumentType args;
+	unsigned long count;
+	long status;
 	
 	/**********
 	 Check Core
 	**********/
-	getCommand(args.s[0], sizeof(args.s[0]), command);
-	
 	/* Check cyclic core */
 	if(core.error) {
+		getCommand(args.s[0], sizeof(args.s[0]), command);
 		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(core.statusID), "%s command request aborted due to critical error in StCore", &args);
 		return core.statusID;
 	}
 	
 	/* Check reference */
 	if(core.pCommandBuffer == NULL) {
+		getCommand(args.s[0], sizeof(args.s[0]), command);
 		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_ALLOCATION), "%s command request cannot reference command buffer", &args);
 		return stCORE_ERROR_ALLOCATION;
 	}
@@ -144,40 +226,34 @@ long coreCommandRequest(unsigned char index, SuperTrakCommand_t command, void *p
 	/**********************
 	 Access command manager
 	**********************/
-	pBuffer = core.pCommandBuffer + index - 1;
-	pCommand = &pBuffer->buffer[pBuffer->write];
-	
-	/* Prepare message */
+	/* Messages are only formatted when logged */
 	getContext(args.s[0], sizeof(args.s[0]), command);
 	args.i[0] = command.u1[1];
-	getCommand(args.s[1], sizeof(args.s[1]), command);
 	
-	/* Check if pending or busy */
-	if(GET_BIT(pCommand->status, CORE_COMMAND_PENDING) || GET_BIT(pCommand->status, CORE_COMMAND_BUSY)) {
-		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_BUFFER), "%s %i %s command rejected because buffer is full", &args);
-		return stCORE_ERROR_BUFFER;
+	status = coreCommandReserve(index, &pCommand, &count);
+	if(status) {
+		getCommand(args.s[1], sizeof(args.s[1]), command);
+		args.i[1] = (long)core.commandPool.used;
+		args.i[2] = (long)core.commandPool.size;
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(status), "%s %i %s command rejected because buffer is full (%i of %i pooled commands in use)", &args);
+		return status;
 	}
 	
-	/* Write command */
-	memcpy(&pCommand->command, &command, sizeof(pCommand->command));
-	
-	/* Update status, tag instance, and share entry */
-	CLEAR_BIT(pCommand->status, CORE_COMMAND_DONE);
-	CLEAR_BIT(pCommand->status, CORE_COMMAND_ERROR);
-	SET_BIT(pCommand->status, CORE_COMMAND_PENDING);
-	pCommand->pInstance = pInstance;
-	if(ppCommand != NULL) *ppCommand = pCommand;
+	/* Share handle and publish */
+	if(pHandle != NULL) *pHandle = coreCommandHandle(pCommand);
+	coreCommandPublish(index, pCommand, &command, pInstance);
 	
 	/* Debug comfirmation message */
-	getParameter(args.s[2], sizeof(args.s[2]), command);
-	logMessage(CORE_LOG_SEVERITY_DEBUG, 4200, "%s %i %s command request (%s)", &args);
+	if(core.debug) {
+		getCommand(args.s[1], sizeof(args.s[1]), command);
+		getParameter(args.s[2], sizeof(args.s[2]), command);
+		logMessage(CORE_LOG_SEVERITY_DEBUG, 4200, "%s %i %s command request (%s)", &args);
+	}
 	
-	/* Increment write index and check if full */
-	pBuffer->write = (pBuffer->write + 1) % CORE_COMMAND_BUFFER_SIZE;
-	pCommand = &pBuffer->buffer[pBuffer->write];
-	if(GET_BIT(pCommand->status, CORE_COMMAND_PENDING) || GET_BIT(pCommand->status, CORE_COMMAND_BUSY)) {
+	/* Check if full, using the count this request reserved as other requests may change it */
+	if(count >= core.commandPool.palletCap) {
 		args.i[0] = index;
-		args.i[1] = CORE_COMMAND_BUFFER_SIZE;
+		args.i[1] = (long)core.commandPool.palletCap;
 		logMessage(CORE_LOG_SEVERITY_WARNING, coreLogCode(stCORE_WARNING_BUFFER), "Pallet %i command buffer is now full (size = %i)", &args);
 	}
 	
@@ -185,6 +261,99 @@ long coreCommandRequest(unsigned char index, SuperTrakCommand_t command, void *p
 	
 } /* End function */
 
+/* Reserve a command node in the pallet's queue without logging, optionally share the queue count including this reservation */
+long coreCommandReserve(unsigned char index, coreCommandType **ppCommand, unsigned long *pCount) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.pCommandBuffer (rw)
+	   core.commandPool
+	  Subroutines:
+	   coreCommandAllocate
+	   coreCommandGeneration
+	************************************************/
+	
+	/* Declare local variables */
+	coreCommandBufferType *pBuffer = core.pCommandBuffer + index - 1;
+	coreCommandType *pCommand;
+	unsigned long count;
+	
+	*ppCommand = NULL;
+	
+	/* Reserve a place in the pallet's queue, requests from any task class may compete for the same buffer */
+	do {
+		count = pBuffer->count;
+		if(count >= core.commandPool.palletCap)
+			return stCORE_ERROR_BUFFER;
+	} while(!__sync_bool_compare_and_swap(&pBuffer->count, count, count + 1));
+	
+	/* Take a node from the shared pool */
+	pCommand = coreCommandAllocate();
+	if(pCommand == NULL) {
+		__sync_fetch_and_sub(&pBuffer->count, 1);
+		return stCORE_ERROR_BUFFER;
+	}
+	
+	/* The node is owned by this request until published, handles to its previous use expire */
+	coreCommandGeneration(pCommand);
+	pCommand->status = 1U << CORE_COMMAND_RESERVED;
+	*ppCommand = pCommand;
+	if(pCount != NULL) *pCount = count + 1;
+	
+	return 0;
+	
+} /* End function */
+
+/* Return a reserved command node that will not be published */
+void coreCommandUnreserve(unsigned char index, coreCommandType *pCommand) {
+	
+	if(pCommand == NULL)
+		return;
+	
+	pCommand->status = 0;
+	coreCommandFree(pCommand);
+	__sync_fetch_and_sub(&core.pCommandBuffer[index - 1].count, 1);
+	
+} /* End function */
+
+/* Write a reserved command node and push it to the pallet's inbox */
+void coreCommandPublish(unsigned char index, coreCommandType *pCommand, SuperTrakCommand_t *pData, void *pInstance) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.pCommandBuffer (w)
+	   core.commandPallets (w)
+	   core.commandPool
+	  Subroutines:
+	   coreCommandHandle
+	************************************************/
+	
+	/* Declare local variables */
+	coreCommandBufferType *pBuffer = core.pCommandBuffer + index - 1;
+	unsigned long node, inbox;
+	
+	/* Write command and tag instance while it is owned by this request */
+	memcpy(&pCommand->command, pData, sizeof(pCommand->command));
+	pCommand->pInstance = pInstance;
+	pCommand->requested = (unsigned long)AsIOTimeStamp();
+	pCommand->attempt = 0;
+	pCommand->index = index;
+	pCommand->group = 0;
+	pCommand->claim = coreCommandHandle(pCommand); /* Allow cancel and replace until sent */
+	pCommand->status = 1U << CORE_COMMAND_PENDING;
+	
+	/* Publish to the command manager by pushing the node to the pallet's inbox */
+	node = (unsigned long)(pCommand - core.commandPool.pNode) + 1;
+	do {
+		inbox = pBuffer->inbox;
+		pCommand->next = (unsigned short)inbox;
+	} while(!__sync_bool_compare_and_swap(&pBuffer->inbox, inbox, node));
+	SET_BITMAP_ATOMIC(core.commandPallets, index - 1); /* Wake the command manager for this pallet */
+	
+} /* End function */
+
 /* Process requested user commands */
 void coreCommandManager(void) {
 	
@@ -195,15 +364,39 @@ void coreCommandManager(void) {
 	   core.pCyclicStatus 
 	   core.pSimpleRelease (rw)
 	   core.pCommandBuffer (rw)
+	   core.commandPool
+	   core.commandPallets (rw)
+	   core.commandTargets (rw)
+	   core.channels (rw)
+	   core.commandTimeouts
 	   core.interface
 	   core.targetCount
 	   core.palletCount
+	   core.commandCount
 	   core.error
 	   core.statusID
 	  Subroutines:
 	   getCommand
 	   getContext
 	   logMessage
+	   takeInbox
+	   dequeueCommand
+	   assignChannel
+	   urgentCommand
+	   coreBitmapFind
+	   coreCommandSelect
+	   coreCommandFinished
+	   coreCommandAssigned
+	   coreCommandTimeout
+	   coreDeadlineExpired
+	   coreDeadlineCancelChannel
+	   coreDeadlineStartTarget
+	   coreDeadlineCancelTarget
+	   coreCommandRetry
+	   coreCommandReady
+	   coreCommandTake
+	   coreGroupAssign
+	   coreGroupMonitor
 	************************************************/
 	
 	/***********************
@@ -213,13 +406,15 @@ void coreCommandManager(void) {
 	coreCommandBufferType *pBuffer;
 	coreCommandType *pCommand;
 	SuperTrakCommand_t *pChannel;
-	long i, j;
-	unsigned char *pStatus, complete, success, pause;
-	static unsigned char used[CORE_COMMAND_BYTE_MAX], reset[CORE_COMMAND_BYTE_MAX], channel, start;
-	static unsigned long timer[CORE_COMMAND_COUNT];
+	long i, k;
+	unsigned long next, active[BITMAP_WORDS(CORE_PALLET_MAX)], activeTargets[BITMAP_WORDS(CORE_TARGET_MAX)];
+	unsigned long released[BITMAP_WORDS(CORE_COMMAND_MAX)], deferred[BITMAP_WORDS(CORE_PALLET_MAX)];
+	unsigned long expiredChannels[BITMAP_WORDS(CORE_COMMAND_MAX)], expiredTargets[BITMAP_WORDS(CORE_TARGET_MAX)];
+	unsigned char *pStatus, complete, success, pause, member;
+	static unsigned char start;
+	coreCommandChannelType *pChannels = &core.channels;
 	coreCommandType *pSimpleCommand; /* Simple target release command storage */
 	unsigned char *pTargetRelease, *pTargetStatus, lowerBit, upperBit; /* Simple target release and target status cyclic bits */
-	unsigned long *pSimpleReleaseTimer;
 	coreFormatArgumentType args;
 	
 	/**********
@@ -245,27 +440,55 @@ void coreCommandManager(void) {
 	}
 	else logAlloc = true;
 	
+	/* Take the commands whose adaptive timeout ends this cycle */
+	coreDeadlineExpired(expiredChannels, expiredTargets);
+	
 	/***********************
 	 Process Command Buffers
 	***********************/
 	pause = false; /* Reset pause for channel availability */
-	i = start; j = 0;
-	while(j++ < core.palletCount) {
+	memset(released, 0, sizeof(released));
+	memset(deferred, 0, sizeof(deferred));
+	
+	/* Visit only pallet buffers with work, each once, starting where the last pause started */
+	for(k = 0; k < BITMAP_WORDS(CORE_PALLET_MAX); k++)
+		active[k] = core.commandPallets[k];
+	next = start;
+	while((i = coreBitmapFind(active, core.palletCount, next)) >= 0) {
+		CLEAR_BITMAP(active, i);
+		next = i + 1;
+		
 		/* Access data */
 		pBuffer = core.pCommandBuffer + i; /* Pallet command buffer */
-		pCommand = &pBuffer->buffer[pBuffer->read]; /* Next command in pallet buffer */
+		if(pBuffer->inbox)
+			takeInbox(pBuffer); /* Queue new requests */
+		while(pBuffer->head && GET_BIT(core.commandPool.pNode[pBuffer->head - 1].status, CORE_COMMAND_CANCELLED)) {
+			/* Remove commands cancelled by the requester, a cancelled group leader takes its members */
+			for(member = MAX(core.commandPool.pNode[pBuffer->head - 1].group, 1); member > 0 && pBuffer->head; member--) {
+				pCommand = core.commandPool.pNode + pBuffer->head - 1;
+				pCommand->status = 1U << CORE_COMMAND_DONE | 1U << CORE_COMMAND_CANCELLED;
+				coreCommandFinished(pCommand, coreCommandSelect(pCommand->command.u1[0]), stCORE_WARNING_CANCELLED);
+				dequeueCommand(pBuffer);
+			}
+		}
+		pCommand = pBuffer->head ? core.commandPool.pNode + pBuffer->head - 1 : NULL; /* Next command in pallet buffer */
+		
+		/* Pallet buffer busy sending a command group, the group is dequeued as one unit */
+		if(pCommand != NULL && pCommand->group && GET_BIT(pCommand->status, CORE_COMMAND_BUSY)) {
+			if(coreGroupMonitor(pCommand, expiredChannels, released)) {
+				for(member = pCommand->group; member > 0; member--)
+					dequeueCommand(pBuffer);
+			}
+		}
 		
 		/* Pallet buffer busy sending command */
-		if(GET_BIT(pCommand->status, CORE_COMMAND_BUSY)) {
+		else if(pCommand != NULL && GET_BIT(pCommand->status, CORE_COMMAND_BUSY)) {
 			/* Access data */
 			pChannel = (SuperTrakCommand_t*)(core.pCyclicControl + core.interface.commandDataOffset) + pBuffer->channel;
 			pStatus = core.pCyclicStatus + core.interface.commandStatusOffset + pBuffer->channel / CORE_COMMAND_STATUS_PER_BYTE;
 			complete = GET_BIT(*pStatus, (pBuffer->channel % CORE_COMMAND_STATUS_PER_BYTE) * CORE_COMMAND_STATUS_BIT_COUNT);
 			success = GET_BIT(*pStatus, (pBuffer->channel % CORE_COMMAND_STATUS_PER_BYTE) * CORE_COMMAND_STATUS_BIT_COUNT + 1);
 			
-			/* Track time */
-			timer[pBuffer->channel] += CORE_CYCLE_TIME;
-			
 			/* Build message */
 			getContext(args.s[0], sizeof(args.s[0]), *pChannel);
 			args.i[0] = pChannel->u1[1];
@@ -276,91 +499,99 @@ void coreCommandManager(void) {
 				/* Confirm success or failure */
 				if(success)
 					logMessage(CORE_LOG_SEVERITY_DEBUG, 4300, "%s %i %s command acknowledged", &args);
-				else {
+				else
 					logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_COMMAND), "%s %i %s command execution failed", &args);
-					SET_BIT(pCommand->status, CORE_COMMAND_ERROR);
-				}
 				
-				/* Clear cyclic data and timer */
+				/* Clear cyclic data and deadline */
 				memset(pChannel, 0, sizeof(*pChannel));
-				timer[pBuffer->channel] = 0;
-				
-				/* Reopen channels only after all pallet buffers have all been polled */
-				SET_BIT(reset[pBuffer->channel / CORE_COMMAND_FLAG_PER_BYTE], pBuffer->channel % CORE_COMMAND_FLAG_PER_BYTE);
+				coreDeadlineCancelChannel(pBuffer->channel);
 				
-				/* Update command status */
-				CLEAR_BIT(pCommand->status, CORE_COMMAND_BUSY);
-				SET_BIT(pCommand->status, CORE_COMMAND_DONE);
+				/* Release the channel */
+				SET_BITMAP(released, pBuffer->channel);
 				
-				/* Move to next command in buffer */
-				pBuffer->read = (pBuffer->read + 1) % CORE_COMMAND_BUFFER_SIZE;
+				/* Update command status and statistics, unless the retry policy sends it again */
+				if(success || !coreCommandRetry(pCommand, coreCommandSelect(pCommand->command.u1[0]), stCORE_ERROR_COMMAND)) {
+					pCommand->status = success ? 1U << CORE_COMMAND_DONE : 1U << CORE_COMMAND_DONE | 1U << CORE_COMMAND_ERROR;
+					coreCommandFinished(pCommand, coreCommandSelect(pCommand->command.u1[0]), success ? 0 : stCORE_ERROR_COMMAND);
+					
+					/* Move to next command in buffer */
+					dequeueCommand(pBuffer);
+				}
 			}
-			else if(timer[pBuffer->channel] >= CORE_COMMAND_TIMEOUT) {
-				logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_TIMEOUT), "%s %i %s command execution timed out", &args);
+			else if(GET_BITMAP(expiredChannels, pBuffer->channel)) {
+				args.i[1] = (long)(coreCommandTimeout(coreCommandSelect(pChannel->u1[0])) * CORE_CYCLE_TIME / 1000);
+				logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_TIMEOUT), "%s %i %s command execution timed out after %i ms", &args);
 				
-				/* Clear cyclic data and timer */
+				/* Clear cyclic data, the deadline has been taken */
 				memset(pChannel, 0, sizeof(*pChannel));
-				timer[pBuffer->channel] = 0;
 				
-				/* Reopen channels only after all pallet buffers have all been polled */
-				SET_BIT(reset[pBuffer->channel / CORE_COMMAND_FLAG_PER_BYTE], pBuffer->channel % CORE_COMMAND_FLAG_PER_BYTE);
+				/* Release the channel */
+				SET_BITMAP(released, pBuffer->channel);
 				
-				/* Update command status */
-				CLEAR_BIT(pCommand->status, CORE_COMMAND_BUSY);
-				SET_BIT(pCommand->status, CORE_COMMAND_DONE);
-				SET_BIT(pCommand->status, CORE_COMMAND_ERROR);
-				
-				/* Move to next command in buffer */
-				pBuffer->read = (pBuffer->read + 1) % CORE_COMMAND_BUFFER_SIZE;
+				/* Update command status and statistics, unless the retry policy sends it again */
+				if(!coreCommandRetry(pCommand, coreCommandSelect(pCommand->command.u1[0]), stCORE_ERROR_TIMEOUT)) {
+					pCommand->status = 1U << CORE_COMMAND_DONE | 1U << CORE_COMMAND_ERROR;
+					coreCommandFinished(pCommand, coreCommandSelect(pCommand->command.u1[0]), stCORE_ERROR_TIMEOUT);
+					
+					/* Move to next command in buffer */
+					dequeueCommand(pBuffer);
+				}
 			}
 		}
 		
-		/* Pallet buffer has command pending */
-		else if(!pause && GET_BIT(pCommand->status, CORE_COMMAND_PENDING)) {
-			/* Is the next channel available? */
-			if(GET_BIT(used[channel / CORE_COMMAND_FLAG_PER_BYTE], channel % CORE_COMMAND_FLAG_PER_BYTE)) {
-				pause = true; /* Pause for the rest of this loop */
+		/* Pallet buffer has command published and pending, a retried command waits for its backoff */
+		else if(!pause && pCommand != NULL && GET_BIT(pCommand->status, CORE_COMMAND_PENDING) && coreCommandReady(pCommand)) {
+			/* Track cycles waiting for a channel */
+			if(pBuffer->waiting < USHRT_MAX)
+				pBuffer->waiting++;
+			
+			/* The priority scheduler defers configuration commands until release commands are assigned */
+			if(core.options.Command.Scheduler == stCORE_SCHEDULER_PRIORITY && !urgentCommand(pBuffer, pCommand))
+				SET_BITMAP(deferred, i);
+			else if((pCommand->group ? coreGroupAssign(pBuffer, pCommand) : assignChannel(pBuffer, pCommand)) == -1) {
+				pause = true; /* All channels are busy or held for a waiting group, pause for the rest of this loop */
 				start = i; /* Remember spot where the pause started */
-				if(logPause) {
-					logPause = false;
-					args.i[0] = i;
-					args.i[1] = channel;
-					logMessage(CORE_LOG_SEVERITY_WARNING, coreLogCode(stCORE_WARNING_CHANNEL), "Pallet command buffers paused at pallet=%i command channel=%i", NULL);
-				}
 			}
-			else {
-				/* Assign the command to the channel */
-				pChannel = (SuperTrakCommand_t*)(core.pCyclicControl + core.interface.commandDataOffset) + channel;
-				memcpy(pChannel, &pCommand->command, sizeof(SuperTrakCommand_t));
-				
-				/* Update command channel and status */
-				pBuffer->channel = channel;
-				CLEAR_BIT(pCommand->status, CORE_COMMAND_PENDING);
-				SET_BIT(pCommand->status, CORE_COMMAND_BUSY);
-				
-				/* Mark the channel as used. Increment channel index */
-				SET_BIT(used[channel / CORE_COMMAND_FLAG_PER_BYTE], channel % CORE_COMMAND_FLAG_PER_BYTE);
-				channel = (channel + 1) % CORE_COMMAND_COUNT;
-				
-				/* Re-enable pause warning log message */
-				logPause = true;
-			} /* Used? */
 		} /* Busy/Pending? */
 		
-		i = (i + 1) % core.palletCount; /* Proceed to next pallet buffer */
+		/* Sleep the pallet buffer once empty, unless a request was pushed meanwhile */
+		if(pBuffer->head == 0) {
+			CLEAR_BITMAP_ATOMIC(core.commandPallets, i);
+			if(pBuffer->inbox)
+				SET_BITMAP_ATOMIC(core.commandPallets, i);
+		}
 	} /* Loop pallets */
 	
-	if(!pause)
-		start = 0; /* Reset start */
-		
-	/* Re-open channels */
-	for(i = 0; i < CORE_COMMAND_COUNT; i++) {
-		if(GET_BIT(reset[i / CORE_COMMAND_FLAG_PER_BYTE], i % CORE_COMMAND_FLAG_PER_BYTE)) {
-			CLEAR_BIT(reset[i / CORE_COMMAND_FLAG_PER_BYTE], i % CORE_COMMAND_FLAG_PER_BYTE);
-			CLEAR_BIT(used[i / CORE_COMMAND_FLAG_PER_BYTE], i % CORE_COMMAND_FLAG_PER_BYTE);
+	/* Assign deferred configuration commands to the remaining channels */
+	next = start;
+	while(!pause && (i = coreBitmapFind(deferred, core.palletCount, next)) >= 0) {
+		CLEAR_BITMAP(deferred, i);
+		next = i + 1;
+		pBuffer = core.pCommandBuffer + i;
+		pCommand = core.commandPool.pNode + pBuffer->head - 1;
+		if((pCommand->group ? coreGroupAssign(pBuffer, pCommand) : assignChannel(pBuffer, pCommand)) == -1) {
+			pause = true;
+			start = i;
 		}
 	}
 	
+	if(pause) {
+		if(logPause) {
+			logPause = false;
+			args.i[0] = start;
+			args.i[1] = core.commandCount;
+			logMessage(CORE_LOG_SEVERITY_WARNING, coreLogCode(stCORE_WARNING_CHANNEL), "Pallet command buffers paused at pallet=%i with all %i command channels busy", &args);
+		}
+	}
+	else {
+		start = 0; /* Reset start */
+		logPause = true; /* Re-enable pause warning log message */
+	}
+		
+	/* Free released channels for the next cycle, the cleared command data must reach SuperTrak for one frame first */
+	for(k = 0; k < BITMAP_WORDS(CORE_COMMAND_MAX); k++)
+		pChannels->free[k] |= released[k];
+	
 	/*********************
 	 Simple Target Release
 	*********************/
@@ -370,32 +601,34 @@ void coreCommandManager(void) {
 	   3. Write new command 1-3 when pending, switch to busy
 	   4. Ackowledge commands when done (!present or error), pass error  
 	*/
-	for(i = 0; i < core.targetCount; i++) { /* i = 0 is Target 1 */
+	for(k = 0; k < BITMAP_WORDS(CORE_TARGET_MAX); k++)
+		activeTargets[k] = core.commandTargets[k];
+	while((i = coreBitmapFind(activeTargets, core.targetCount, 0)) >= 0) { /* i = 0 is Target 1 */
+		CLEAR_BITMAP(activeTargets, i);
 		pSimpleCommand = core.pSimpleRelease + i;
 		pTargetRelease = core.pCyclicControl + core.interface.targetControlOffset + (i + 1) / CORE_TARGET_RELEASE_PER_BYTE; /* Cyclic data starts with Target 0 */
 		pTargetStatus = core.pCyclicStatus + core.interface.targetStatusOffset + CORE_TARGET_STATUS_BYTE_COUNT * (i + 1);
-		pSimpleReleaseTimer = (unsigned long*)&pSimpleCommand->command.u1[4]; /* Use upper four bytes for timeout monitoring */
 		lowerBit = ((i + 1) % CORE_TARGET_RELEASE_PER_BYTE) * CORE_TARGET_RELEASE_BIT_COUNT;
 		upperBit = lowerBit + 1;
 		
 		/* This target's simple release command is in progress */
 		if(GET_BIT(pSimpleCommand->status, CORE_COMMAND_BUSY)) {
-			*pSimpleReleaseTimer += CORE_CYCLE_TIME;
-			
 			/* 1. First check for an error */
 			if(GET_BIT(*pTargetStatus, stTARGET_RELEASE_ERROR)) {
 				args.i[0] = i + 1;
 				args.i[1] = pSimpleCommand->command.u1[0];
 				logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_COMMAND), "Target %i release from local move configuration %i has failed", &args);
 				
-				/* Clear release bits */
+				/* Clear release bits and deadline */
 				CLEAR_BIT(*pTargetRelease, lowerBit);
 				CLEAR_BIT(*pTargetRelease, upperBit);
+				coreDeadlineCancelTarget((unsigned char)i);
 				
-				/* Update status */
-				CLEAR_BIT(pSimpleCommand->status, CORE_COMMAND_BUSY);
-				SET_BIT(pSimpleCommand->status, CORE_COMMAND_DONE);
-				SET_BIT(pSimpleCommand->status, CORE_COMMAND_ERROR);
+				/* Update status and statistics, unless the retry policy sends it again */
+				if(!coreCommandRetry(pSimpleCommand, CORE_COMMAND_SIMPLE, stCORE_ERROR_COMMAND)) {
+					pSimpleCommand->status = 1U << CORE_COMMAND_DONE | 1U << CORE_COMMAND_ERROR;
+					coreCommandFinished(pSimpleCommand, CORE_COMMAND_SIMPLE, stCORE_ERROR_COMMAND);
+				}
 			}
 			
 			/* 2. Next check for not present */
@@ -405,33 +638,44 @@ void coreCommandManager(void) {
 				args.i[1] = pSimpleCommand->command.u1[0];
 				logMessage(CORE_LOG_SEVERITY_DEBUG, 4300, "Target %i release from local move configuration %i acknowledged", &args);
 				
-				/* Clear release bits */
+				/* Clear release bits and deadline */
 				CLEAR_BIT(*pTargetRelease, lowerBit);
 				CLEAR_BIT(*pTargetRelease, upperBit);
+				coreDeadlineCancelTarget((unsigned char)i);
 				
-				/* Update status */
-				CLEAR_BIT(pSimpleCommand->status, CORE_COMMAND_BUSY);
-				SET_BIT(pSimpleCommand->status, CORE_COMMAND_DONE);
+				/* Update status and statistics */
+				pSimpleCommand->status = 1U << CORE_COMMAND_DONE;
+				coreCommandFinished(pSimpleCommand, CORE_COMMAND_SIMPLE, 0);
 			}
 			
 			/* 3. Check for timeout */
-			else if(*pSimpleReleaseTimer > CORE_COMMAND_TIMEOUT) {
+			else if(GET_BITMAP(expiredTargets, i)) {
 				args.i[0] = i + 1;
 				args.i[1] = pSimpleCommand->command.u1[0];
-				logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_TIMEOUT), "Target %i release from local move configuration %i has timed out", &args);
+				args.i[2] = (long)(coreCommandTimeout(CORE_COMMAND_SIMPLE) * CORE_CYCLE_TIME / 1000);
+				logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_TIMEOUT), "Target %i release from local move configuration %i has timed out after %i ms", &args);
 				
-				/* Clear release bits */
+				/* Clear release bits, the deadline has been taken */
 				CLEAR_BIT(*pTargetRelease, lowerBit);
 				CLEAR_BIT(*pTargetRelease, upperBit);
 				
-				/* Update status */
-				CLEAR_BIT(pSimpleCommand->status, CORE_COMMAND_BUSY);
-				SET_BIT(pSimpleCommand->status, CORE_COMMAND_DONE);
-				SET_BIT(pSimpleCommand->status, CORE_COMMAND_ERROR);
+				/* Update status and statistics, unless the retry policy sends it again */
+				if(!coreCommandRetry(pSimpleCommand, CORE_COMMAND_SIMPLE, stCORE_ERROR_TIMEOUT)) {
+					pSimpleCommand->status = 1U << CORE_COMMAND_DONE | 1U << CORE_COMMAND_ERROR;
+					coreCommandFinished(pSimpleCommand, CORE_COMMAND_SIMPLE, stCORE_ERROR_TIMEOUT);
+				}
 			}
 		}
-		/* This target has a simple release request pending */
-		else if(GET_BIT(pSimpleCommand->status, CORE_COMMAND_PENDING)) {
+		/* This target's simple release was cancelled, report it before the target may be requested again */
+		else if(GET_BIT(pSimpleCommand->status, CORE_COMMAND_CANCELLED) && !GET_BIT(pSimpleCommand->status, CORE_COMMAND_DONE)) {
+			coreCommandFinished(pSimpleCommand, CORE_COMMAND_SIMPLE, stCORE_WARNING_CANCELLED);
+			pSimpleCommand->status = 1U << CORE_COMMAND_DONE | 1U << CORE_COMMAND_CANCELLED;
+		}
+		
+		/* This target has a simple release request pending, a retried release waits for its backoff and a cancelled release is skipped */
+		else if(GET_BIT(pSimpleCommand->status, CORE_COMMAND_PENDING) && coreCommandReady(pSimpleCommand) && coreCommandTake(pSimpleCommand)) {
+			__sync_synchronize(); /* Read the command after its publication */
+			
 			/* Write command in cyclic control */
 			switch(pSimpleCommand->command.u1[0]) {
 				case 1:
@@ -446,14 +690,21 @@ void coreCommandManager(void) {
 					SET_BIT(*pTargetRelease, upperBit);
 			}
 			
-			/* Update status */
-			CLEAR_BIT(pSimpleCommand->status, CORE_COMMAND_PENDING);
-			SET_BIT(pSimpleCommand->status, CORE_COMMAND_BUSY);
+			/* Update status in a single write so the command never appears free to a request */
+			pSimpleCommand->status = 1U << CORE_COMMAND_BUSY;
+			coreCommandAssigned(pSimpleCommand, CORE_COMMAND_SIMPLE);
 			
-			/* Reset request timer */
-			*pSimpleReleaseTimer = 0;
+			/* Start the timeout */
+			coreDeadlineStartTarget((unsigned char)i);
 			
 		} /* Busy?, pending? */
+		
+		/* Sleep the target once done, unless a request published meanwhile */
+		if(!GET_BIT(pSimpleCommand->status, CORE_COMMAND_BUSY) && !GET_BIT(pSimpleCommand->status, CORE_COMMAND_PENDING)) {
+			CLEAR_BITMAP_ATOMIC(core.commandTargets, i);
+			if(GET_BIT(pSimpleCommand->status, CORE_COMMAND_PENDING))
+				SET_BITMAP_ATOMIC(core.commandTargets, i);
+		}
 	} /* Loop targets */
 	
 } /* End function */
@@ -463,6 +714,150 @@ long logMessage(coreLogSeverityEnum severity, unsigned short code, char *message
 	return coreLog(core.ident, severity, CORE_LOGBOOK_FACILITY, code, LOG_OBJECT, message, args);
 }
 
+/* Take all requests from the pallet's inbox and append them to its queue in request order */
+void takeInbox(coreCommandBufferType *pBuffer) {
+	
+	/* Declare local variables */
+	coreCommandType *pCommand;
+	unsigned long node, first, following;
+	
+	node = __sync_lock_test_and_set(&pBuffer->inbox, 0);
+	__sync_synchronize();
+	
+	/* The inbox is linked newest first, reverse it */
+	first = 0;
+	while(node) {
+		pCommand = core.commandPool.pNode + node - 1;
+		following = pCommand->next;
+		pCommand->next = (unsigned short)first;
+		first = node;
+		node = following;
+	}
+	
+	/* Append each request */
+	while(first) {
+		node = first;
+		pCommand = core.commandPool.pNode + node - 1;
+		first = pCommand->next;
+		pCommand->next = 0;
+		
+		/* Coalesce here rather than in coreCommandRequest, only the command manager may unlink queued commands */
+		if(core.options.Command.Coalesce)
+			coalesceCommand(pBuffer, pCommand);
+		
+		if(pBuffer->tail)
+			core.commandPool.pNode[pBuffer->tail - 1].next = (unsigned short)node;
+		else
+			pBuffer->head = (unsigned short)node;
+		pBuffer->tail = (unsigned short)node;
+	}
+}
+
+/* Supersede the last queued command if it is a pending configuration command of the same kind */
+void coalesceCommand(coreCommandBufferType *pBuffer, coreCommandType *pCommand) {
+	
+	/* Declare local variables */
+	coreCommandType *pTail;
+	unsigned long node;
+	coreFormatArgumentType args;
+	
+	/* Only the immediately preceding command is replaced so commands of other kinds keep their order */
+	if(pBuffer->tail == 0)
+		return;
+	pTail = core.commandPool.pNode + pBuffer->tail - 1;
+	if(!GET_BIT(pTail->status, CORE_COMMAND_PENDING))
+		return;
+	if(pTail->command.u1[0] != pCommand->command.u1[0] || pTail->command.u1[1] != pCommand->command.u1[1])
+		return;
+	if(pCommand->command.u1[0] < CORE_COMMAND_ID_MOTION)
+		return; /* Motion, mechanical, and control parameters only */
+	if(pTail->group)
+		return; /* A group leader is never replaced by a member or later request */
+	if(!coreCommandTake(pTail))
+		return; /* Cancelled or being replaced by the requester */
+	
+	/* Unlink the tail, the queue is at most the pallet cap long */
+	if(pBuffer->head == pBuffer->tail)
+		pBuffer->head = pBuffer->tail = 0;
+	else {
+		node = pBuffer->head;
+		while(core.commandPool.pNode[node - 1].next != pBuffer->tail)
+			node = core.commandPool.pNode[node - 1].next;
+		core.commandPool.pNode[node - 1].next = 0;
+		pBuffer->tail = (unsigned short)node;
+	}
+	
+	getContext(args.s[0], sizeof(args.s[0]), pTail->command);
+	args.i[0] = pTail->command.u1[1];
+	getCommand(args.s[1], sizeof(args.s[1]), pTail->command);
+	logMessage(CORE_LOG_SEVERITY_WARNING, coreLogCode(stCORE_WARNING_SUPERSEDED), "%s %i %s command superseded by a newer request", &args);
+	
+	/* Notify the requester and return the node to the pool */
+	pTail->status = 1U << CORE_COMMAND_DONE | 1U << CORE_COMMAND_SUPERSEDED;
+	coreCommandFree(pTail);
+	__sync_fetch_and_sub(&pBuffer->count, 1);
+}
+
+/* Remove the completed command at the head of the pallet's queue and return it to the pool */
+void dequeueCommand(coreCommandBufferType *pBuffer) {
+	
+	/* Declare local variables */
+	coreCommandType *pCommand;
+	
+	if(pBuffer->head == 0)
+		return;
+	
+	pCommand = core.commandPool.pNode + pBuffer->head - 1;
+	pBuffer->head = pCommand->next;
+	if(pBuffer->head == 0)
+		pBuffer->tail = 0;
+	
+	coreCommandFree(pCommand);
+	__sync_fetch_and_sub(&pBuffer->count, 1);
+}
+
+/* Write the pallet's pending command to any free channel, return the channel, -1 if all are busy, or -2 if the requester holds the command */
+long assignChannel(coreCommandBufferType *pBuffer, coreCommandType *pCommand) {
+	
+	/* Declare local variables */
+	coreCommandChannelType *pChannels = &core.channels;
+	SuperTrakCommand_t *pChannel;
+	long channel;
+	
+	/* Find any free channel, starting after the last assigned */
+	channel = coreBitmapFind(pChannels->free, core.commandCount, pChannels->next);
+	if(channel < 0)
+		return -1;
+	
+	/* Take the command from cancel and replace, it is sent only if taken */
+	if(!coreCommandTake(pCommand))
+		return -2;
+	
+	/* Assign the command to the channel */
+	pChannel = (SuperTrakCommand_t*)(core.pCyclicControl + core.interface.commandDataOffset) + channel;
+	memcpy(pChannel, &pCommand->command, sizeof(SuperTrakCommand_t));
+	
+	/* Update command channel and status */
+	pBuffer->channel = (unsigned char)channel;
+	pBuffer->waiting = 0;
+	pCommand->status = 1U << CORE_COMMAND_BUSY;
+	coreCommandAssigned(pCommand, coreCommandSelect(pCommand->command.u1[0]));
+	coreDeadlineStartChannel((unsigned char)channel, coreCommandSelect(pCommand->command.u1[0]));
+	
+	/* Take the channel and search from the next one so released channels are reused last */
+	CLEAR_BITMAP(pChannels->free, channel);
+	pChannels->next = (unsigned char)((channel + 1) % core.commandCount);
+	
+	return channel;
+}
+
+/* Release and continue commands have priority, configuration commands gain it after the aging time */
+unsigned char urgentCommand(coreCommandBufferType *pBuffer, coreCommandType *pCommand) {
+	if(pCommand->group || pCommand->command.u1[0] < CORE_COMMAND_ID_PALLET_ID) /* A group usually ends with a release */
+		return true;
+	return (unsigned long)pBuffer->waiting * CORE_CYCLE_TIME >= core.options.Command.AgingTime * 1000;
+}
+
 /* Write lowercase command name to str */
 void getCommand(char *str, unsigned long size, SuperTrakCommand_t data) {
 	if(CORE_COMMAND_ID_RELEASE <= data.u1[0] && data.u1[0] <= CORE_COMMAND_ID_RELEASE + 3)
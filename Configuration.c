@@ -8,16 +8,20 @@
 
 /* Set ID of pallet at target */
 long StCoreSetPalletID(unsigned char Target, unsigned char PalletID) {
-	return coreSetPalletID(Target, PalletID, NULL, NULL);
+	unsigned long handle;
+	long status;
+	status = coreSetPalletID(Target, PalletID, NULL, &handle);
+	return status ? status : (long)handle; /* Command handle on success */
 }
 
 /* (Internal) Set ID of pallet at target */
-long coreSetPalletID(unsigned char target, unsigned char palletID, void *pInstance, coreCommandType **ppCommand) {
+long coreSetPalletID(unsigned char target, unsigned char palletID, void *pInstance, unsigned long *pHandle) {
 	
 	/************************************************
 	 Dependencies:
 	  Subroutines:
 	   coreCommandCreate
+	   coreCommandPack
 	   coreCommandRequest
 	************************************************/
 
@@ -38,15 +42,12 @@ long coreSetPalletID(unsigned char target, unsigned char palletID, void *pInstan
 	/**************
 	 Create command
 	**************/
-	memset(&command, 0, sizeof(command));
-	command.u1[0] = assign.commandID;
-	command.u1[1] = assign.context;
-	command.u1[2] = palletID;
+	coreCommandPack(CORE_COMMAND_ID_PALLET_ID, &assign, palletID, 0.0, 0.0, &command);
 	
 	/***************
 	 Request command
 	***************/
-	status = coreCommandRequest(assign.index, command, pInstance, ppCommand);
+	status = coreCommandRequest(assign.index, command, pInstance, pHandle);
 	if(status)
 		return status;
 	
@@ -56,16 +57,20 @@ long coreSetPalletID(unsigned char target, unsigned char palletID, void *pInstan
 
 /* Set pallet velocity and/or acceleration */
 long StCoreSetMotionParameters(unsigned char Target, unsigned char Pallet, double Velocity, double Acceleration) {
-	return coreSetMotionParameters(Target, Pallet, Velocity, Acceleration, NULL, NULL);
+	unsigned long handle;
+	long status;
+	status = coreSetMotionParameters(Target, Pallet, Velocity, Acceleration, NULL, &handle);
+	return status ? status : (long)handle; /* Command handle on success */
 }
 
 /* (Internal) Set pallet velocity and/or acceleration */
-long coreSetMotionParameters(unsigned char target, unsigned char pallet, double velocity, double acceleration, void *pInstance, coreCommandType **ppCommand) {
+long coreSetMotionParameters(unsigned char target, unsigned char pallet, double velocity, double acceleration, void *pInstance, unsigned long *pHandle) {
 	
 	/************************************************
 	 Dependencies:
 	  Subroutines:
 	   coreCommandCreate
+	   coreCommandPack
 	   coreCommandRequest
 	************************************************/
 
@@ -73,7 +78,6 @@ long coreSetMotionParameters(unsigned char target, unsigned char pallet, double
 	 Declare local variables
 	***********************/
 	long status;
-	unsigned short value;
 	coreCommandCreateType assign;
 	SuperTrakCommand_t command;
 	
@@ -87,18 +91,12 @@ long coreSetMotionParameters(unsigned char target, unsigned char pallet, double
 	/**************
 	 Create command
 	**************/
-	memset(&command, 0, sizeof(command));
-	command.u1[0] = assign.commandID;
-	command.u1[1] = assign.context;
-	value = (unsigned short)velocity;
-	memcpy(&command.u1[2], &value, 2);
-	value = (unsigned short)(acceleration / 1000.0);
-	memcpy(&command.u1[4], &value, 2);
+	coreCommandPack(CORE_COMMAND_ID_MOTION, &assign, 0, velocity, acceleration, &command);
 	
 	/***************
 	 Request command
 	***************/
-	status = coreCommandRequest(assign.index, command, pInstance, ppCommand);
+	status = coreCommandRequest(assign.index, command, pInstance, pHandle);
 	if(status)
 		return status;
 	
@@ -108,16 +106,20 @@ long coreSetMotionParameters(unsigned char target, unsigned char pallet, double
 
 /* Set pallet shelf width and offset */
 long StCoreSetMechanicalParameters(unsigned char Target, unsigned char Pallet, double ShelfWidth, double CenterOffset) {
-	return coreSetMechanicalParameters(Target, Pallet, ShelfWidth, CenterOffset, NULL, NULL);
+	unsigned long handle;
+	long status;
+	status = coreSetMechanicalParameters(Target, Pallet, ShelfWidth, CenterOffset, NULL, &handle);
+	return status ? status : (long)handle; /* Command handle on success */
 }
 
 /* (Internal) Set pallet shelf width and offset */
-long coreSetMechanicalParameters(unsigned char target, unsigned char pallet, double shelfWidth, double centerOffset, void *pInstance, coreCommandType **ppCommand) {
+long coreSetMechanicalParameters(unsigned char target, unsigned char pallet, double shelfWidth, double centerOffset, void *pInstance, unsigned long *pHandle) {
 	
 	/************************************************
 	 Dependencies:
 	  Subroutines:
 	   coreCommandCreate
+	   coreCommandPack
 	   coreCommandRequest
 	************************************************/
 
@@ -125,7 +127,6 @@ long coreSetMechanicalParameters(unsigned char target, unsigned char pallet, dou
 	 Declare local variables
 	***********************/
 	long status;
-	unsigned short value;
 	coreCommandCreateType assign;
 	SuperTrakCommand_t command;
 	
@@ -139,18 +140,12 @@ long coreSetMechanicalParameters(unsigned char target, unsigned char pallet, dou
 	/**************
 	 Create command
 	**************/
-	memset(&command, 0, sizeof(command));
-	command.u1[0] = assign.commandID;
-	command.u1[1] = assign.context;
-	value = (unsigned short)(shelfWidth * 10.0); /* Units of 0.1 mm */
-	memcpy(&command.u1[2], &value, 2);
-	value = (unsigned short)(centerOffset * 10.0); /* Units of 0.1 mm */
-	memcpy(&command.u1[4], &value, 2);
+	coreCommandPack(CORE_COMMAND_ID_MECHANICAL, &assign, 0, shelfWidth, centerOffset, &command);
 	
 	/***************
 	 Request command
 	***************/
-	status = coreCommandRequest(assign.index, command, pInstance, ppCommand);
+	status = coreCommandRequest(assign.index, command, pInstance, pHandle);
 	if(status)
 		return status;
 	
@@ -160,16 +155,20 @@ long coreSetMechanicalParameters(unsigned char target, unsigned char pallet, dou
 
 /* Set pallet control parameters */
 long StCoreSetControlParameters(unsigned char Target, unsigned char Pallet, unsigned char ControlGainSet, double MovingFilter, double StationaryFilter) {
-	return coreSetControlParameters(Target, Pallet, ControlGainSet, MovingFilter, StationaryFilter, NULL, NULL);
+	unsigned long handle;
+	long status;
+	status = coreSetControlParameters(Target, Pallet, ControlGainSet, MovingFilter, StationaryFilter, NULL, &handle);
+	return status ? status : (long)handle; /* Command handle on success */
 }
 
 /* (Internal) Set pallet control parameters */
-long coreSetControlParameters(unsigned char target, unsigned char pallet, unsigned char controlGainSet, double movingFilter, double stationaryFilter, void *pInstance, coreCommandType **ppCommand) {
+long coreSetControlParameters(unsigned char target, unsigned char pallet, unsigned char controlGainSet, double movingFilter, double stationaryFilter, void *pInstance, unsigned long *pHandle) {
 	
 	/************************************************
 	 Dependencies:
 	  Subroutines:
 	   coreCommandCreate
+	   coreCommandPack
 	   coreCommandRequest
 	************************************************/
 	
@@ -190,17 +189,12 @@ long coreSetControlParameters(unsigned char target, unsigned char pallet, unsign
 	/**************
 	 Create command
 	**************/
-	memset(&command, 0, sizeof(command));
-	command.u1[0] = assign.commandID;
-	command.u1[1] = assign.context;
-	command.u1[2] = controlGainSet;
-	command.u1[3] = (unsigned char)(fmax(0.0, fmin(99.0, movingFilter * 100.0)));
-	command.u1[4] = (unsigned char)(fmax(0.0, fmin(99.0, stationaryFilter * 100.0)));
+	coreCommandPack(CORE_COMMAND_ID_CONTROL, &assign, controlGainSet, movingFilter, stationaryFilter, &command);
 	
 	/***************
 	 Request command
 	***************/
-	status = coreCommandRequest(assign.index, command, pInstance, ppCommand);
+	status = coreCommandRequest(assign.index, command, pInstance, pHandle);
 	if(status)
 		return status;
 	
@@ -19,14 +19,20 @@ long StCoreCyclic(void) {
 	   core.pCyclicControl
 	   core.pCyclicStatus (w)
 	   core.interface
-	   core.palletMap (w)
 	   core.pPalletData (w)
 	   core.palletCount
 	   core.ready (w)
 	   core.error (w)
 	   core.statusID (w)
+	   core.cycleCount (w)
+	   core.log (w)
 	  Subroutines:
 	   logMessage
+	   coreSectionTelemetry
+	   corePalletUpdate
+	   coreSnapshotPublish
+	   coreTimingStart
+	   coreTimingRecord
 	************************************************/
 	
 	/***********************
@@ -36,11 +42,17 @@ long StCoreCyclic(void) {
 	RTInfo_typ fbRTInfo;
 	coreFormatArgumentType args;
 	static unsigned long timerSave, saveParameters;
-	long status, i;
+	long status;
 	SuperTrakControlIfConfig_t currentInterfaceConfig;
 	static SuperTrakControlInterface_t controlInterface;
-	SuperTrakPalletInfo_t *pPalletData;
 	unsigned short palletPresentCount, *pSystemPalletCount;
+	unsigned long cycleStart, timestamp;
+	
+	/* Begin execution timing */
+	cycleStart = coreTimingStart();
+	timestamp = cycleStart;
+	core.cycleCount++;
+	core.log.cyclic = true; /* Defer logging to StCoreLogFlush */
 	
 	/************
 	 Verification
@@ -104,6 +116,7 @@ long StCoreCyclic(void) {
 	
 	/* Process StCore commands */
 	coreCommandManager();
+	timestamp = coreTimingRecord(CORE_PHASE_COMMAND, timestamp);
 	
 	/* Reference control interface */
 	controlInterface.pControl = (unsigned long)core.pCyclicControl;
@@ -118,57 +131,65 @@ long StCoreCyclic(void) {
 			memset(core.pCyclicControl, 0, core.interface.controlSize); /* Clear control data on critical error */
 		SuperTrakProcessControl(0, &controlInterface);
 	}
+	timestamp = coreTimingRecord(CORE_PHASE_CONTROL, timestamp);
 		
 	/* Process SuperTrak interface */
 	SuperTrakCyclic1();
+	timestamp = coreTimingRecord(CORE_PHASE_CYCLIC, timestamp);
 	
 	/* Process SuperTrak status */
 	if(core.pCyclicControl && core.pCyclicStatus && core.ready) /* Only process status data if the references are valid */
 		SuperTrakProcessStatus(0, &controlInterface);
+	timestamp = coreTimingRecord(CORE_PHASE_STATUS, timestamp);
 		
 	/* Monitor faults */
 	coreMonitorSuperTrakFault();
+	timestamp = coreTimingRecord(CORE_PHASE_FAULT, timestamp);
+	
+	/* Read section parameters */
+	coreSectionTelemetry();
+	timestamp = coreTimingRecord(CORE_PHASE_TELEMETRY, timestamp);
 	
 	/**************
 	 Pallet Manager
 	**************/
-	/* Reset mapping */
-	memset(&core.palletMap, -1, sizeof(core.palletMap));
-	
 	/* Do not proceed if error or not ready */
 	if(core.error) {
 		if(core.pPalletData)
 			memset(core.pPalletData, 0, sizeof(SuperTrakPalletInfo_t) * core.palletCount); /* Clear pallet data on critical error */
-		return core.statusID;
 	}
-	
-	/* Read pallet information */
-	SuperTrakGetPalletInfo((unsigned long)core.pPalletData, core.palletCount, false); /* Read memory structure from 0 to palletCount - 1 */
-	
-	/* Update pallet mapping */
-	palletPresentCount = 0;
-	for(i = 0; i < core.palletCount; i++) {
-		pPalletData = core.pPalletData + i;
-		/* Mapping the pallet ID if assigned (non-zero) to offset in memory structure (i) */
-		if(pPalletData->palletID)
-			core.palletMap[pPalletData->palletID] = i;
-		
-		/* Count the number of pallets present up to the user allocated amount */
-		if(GET_BIT(pPalletData->status, stPALLET_PRESENT))
-			palletPresentCount++;
+	else {
+		/* Read pallet information */
+		SuperTrakGetPalletInfo((unsigned long)core.pPalletData, core.palletCount, false); /* Read memory structure from 0 to palletCount - 1 */
 	}
 	
+	/* Update pallet mapping and publish changes */
+	palletPresentCount = corePalletUpdate();
+	
 	/* Compare pallets present from allocated data to system total pallets */
-	pSystemPalletCount = (unsigned short*)(core.pCyclicStatus + core.interface.systemStatusOffset + 2);
-	if(palletPresentCount != *pSystemPalletCount && !core.error && core.ready) {
-		args.i[0] = *pSystemPalletCount;
-		args.i[1] = palletPresentCount;
-		args.i[2] = core.palletCount;
-		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_PALLET), "%i total pallets with %i allocated. Increase PalletCount %i in StCoreInit", &args);
-		core.error = true;
-		return core.statusID = stCORE_ERROR_PALLET;
+	if(!core.error) {
+		pSystemPalletCount = (unsigned short*)(core.pCyclicStatus + core.interface.systemStatusOffset + 2);
+		if(palletPresentCount != *pSystemPalletCount && core.ready) {
+			args.i[0] = *pSystemPalletCount;
+			args.i[1] = palletPresentCount;
+			args.i[2] = core.palletCount;
+			logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_PALLET), "%i total pallets with %i allocated. Increase PalletCount %i in StCoreInit", &args);
+			core.error = true;
+			core.statusID = stCORE_ERROR_PALLET;
+		}
 	}
 	
+	/* Publish status for lower priority tasks */
+	coreSnapshotPublish();
+	
+	/* Complete execution timing */
+	coreTimingRecord(CORE_PHASE_PALLET, timestamp);
+	coreTimingRecord(CORE_PHASE_TOTAL, cycleStart);
+	core.log.cyclic = false;
+	
+	if(core.error)
+		return core.statusID;
+	
 	return 0;
 	
 } /* End function */
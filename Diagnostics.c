@@ -0,0 +1,170 @@
+/*******************************************************************************
+ * File: StCore\Diagnostics.c
+ * Author: agent
+ * Date: 2026-10-17
+*******************************************************************************/
+
+#include "Main.h"
+
+/* Prototypes */
+static void resetOutput(StCoreDiagnostics_typ *inst);
+static void copyTiming(StCoreTimingType *pTiming, coreTimingType *pSource);
+
+/* Upper limit of each histogram bucket in microseconds, the last bucket has no limit */
+static const unsigned long bucketLimit[CORE_TIMING_BUCKET_COUNT - 1] = {10, 20, 50, 100, 200, 400, CORE_CYCLE_TIME};
+
+/* Begin timing of StCoreCyclic and apply any pending reset */
+unsigned long coreTimingStart(void) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.diagnostics (w)
+	   core.commandPool (w)
+	   core.commandStatistics (w)
+	************************************************/
+	
+	/* Reset is requested by StCoreDiagnostics or StCoreCommandStatistics and applied here so statistics are only written in task class #1 */
+	if(core.diagnostics.reset) {
+		memset(&core.diagnostics, 0, sizeof(core.diagnostics));
+		core.commandPool.highWater = core.commandPool.used;
+		core.commandPool.rejected = 0;
+	}
+	if(core.commandStatistics.reset)
+		memset(&core.commandStatistics, 0, sizeof(core.commandStatistics));
+	
+	return (unsigned long)AsIOTimeStamp();
+	
+} /* End function */
+
+/* Record the execution time of a phase since start and return the current timestamp */
+unsigned long coreTimingRecord(coreCyclicPhaseEnum phase, unsigned long start) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.diagnostics (w)
+	************************************************/
+	
+	/* Declare local variables */
+	unsigned long now, elapsed;
+	
+	now = (unsigned long)AsIOTimeStamp();
+	elapsed = now - start; /* Unsigned difference is valid across timestamp rollover */
+	
+	coreTimingAdd(&core.diagnostics.phase[phase], elapsed, bucketLimit);
+	
+	if(phase == CORE_PHASE_TOTAL && elapsed > CORE_CYCLE_TIME)
+		core.diagnostics.overruns++;
+	
+	return now;
+	
+} /* End function */
+
+/* Add an elapsed time to statistics, pLimit holds the upper limit of each bucket except the last */
+void coreTimingAdd(coreTimingType *pTiming, unsigned long elapsed, const unsigned long *pLimit) {
+	
+	/* Declare local variables */
+	unsigned char i;
+	
+	pTiming->last = elapsed;
+	if(pTiming->count == 0 || elapsed < pTiming->min)
+		pTiming->min = elapsed;
+	if(elapsed > pTiming->max)
+		pTiming->max = elapsed;
+	pTiming->total += (double)elapsed;
+	pTiming->count++;
+	
+	/* Find the bucket */
+	for(i = 0; i < CORE_TIMING_BUCKET_COUNT - 1; i++) {
+		if(elapsed < pLimit[i])
+			break;
+	}
+	pTiming->histogram[i]++;
+	
+} /* End function */
+
+/* StCore diagnostics interface */
+void StCoreDiagnostics(StCoreDiagnostics_typ *inst) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.cycleCount
+	   core.diagnostics (w)
+	   core.log
+	   core.commandPool
+	  Subroutines:
+	   resetOutput
+	   copyTiming
+	************************************************/
+	
+	/* Interrupt if disabled */
+	if(inst->Enable == false)
+		inst->Internal.State = CORE_FUNCTION_DISABLED;
+	
+	switch(inst->Internal.State) {
+		case CORE_FUNCTION_DISABLED:
+			resetOutput(inst);
+			if(inst->Enable)
+				inst->Internal.State = CORE_FUNCTION_EXECUTING;
+			break;
+		
+		default:
+			/* Request reset on rising edge, StCoreCyclic clears the statistics on its next call */
+			if(inst->Reset && !GET_BIT(inst->Internal.PreviousCommand, 0))
+				core.diagnostics.reset = true;
+			
+			/* Statistics remain available during a critical error in StCore */
+			inst->Cyclic.CycleCount = core.cycleCount;
+			inst->Cyclic.Overruns = core.diagnostics.overruns;
+			copyTiming(&inst->Cyclic.Total, &core.diagnostics.phase[CORE_PHASE_TOTAL]);
+			copyTiming(&inst->Cyclic.CommandManager, &core.diagnostics.phase[CORE_PHASE_COMMAND]);
+			copyTiming(&inst->Cyclic.ProcessControl, &core.diagnostics.phase[CORE_PHASE_CONTROL]);
+			copyTiming(&inst->Cyclic.Cyclic1, &core.diagnostics.phase[CORE_PHASE_CYCLIC]);
+			copyTiming(&inst->Cyclic.ProcessStatus, &core.diagnostics.phase[CORE_PHASE_STATUS]);
+			copyTiming(&inst->Cyclic.FaultMonitor, &core.diagnostics.phase[CORE_PHASE_FAULT]);
+			copyTiming(&inst->Cyclic.SectionTelemetry, &core.diagnostics.phase[CORE_PHASE_TELEMETRY]);
+			copyTiming(&inst->Cyclic.PalletManager, &core.diagnostics.phase[CORE_PHASE_PALLET]);
+			
+			inst->FaultMonitor.Reads = core.diagnostics.faultReads;
+			inst->FaultMonitor.SweepReads = core.diagnostics.faultSweeps;
+			inst->FaultMonitor.Pending = core.diagnostics.faultPending;
+			
+			inst->Log.Deferred = core.log.write;
+			inst->Log.Pending = core.log.write - core.log.read;
+			inst->Log.Dropped = core.log.dropped;
+			
+			inst->Command.PoolSize = core.commandPool.size;
+			inst->Command.Used = core.commandPool.used;
+			inst->Command.HighWater = core.commandPool.highWater;
+			inst->Command.Rejected = core.commandPool.rejected;
+			
+			inst->Valid = true;
+			break;
+	}
+	
+	coreAssign16(&inst->Internal.PreviousCommand, 0, inst->Reset);
+	
+} /* End function */
+
+/* Clear instance outputs */
+void resetOutput(StCoreDiagnostics_typ *inst) {
+	inst->Valid = false;
+	inst->Error = false;
+	inst->StatusID = 0;
+	memset(&inst->Cyclic, 0, sizeof(inst->Cyclic));
+	memset(&inst->FaultMonitor, 0, sizeof(inst->FaultMonitor));
+	memset(&inst->Log, 0, sizeof(inst->Log));
+	memset(&inst->Command, 0, sizeof(inst->Command));
+}
+
+/* Copy internal timing statistics to user structure */
+void copyTiming(StCoreTimingType *pTiming, coreTimingType *pSource) {
+	pTiming->Last = pSource->last;
+	pTiming->Min = pSource->min;
+	pTiming->Max = pSource->max;
+	pTiming->Count = pSource->count;
+	pTiming->Mean = pSource->count ? (float)(pSource->total / (double)pSource->count) : 0.0;
+	memcpy(pTiming->Histogram, pSource->histogram, sizeof(pTiming->Histogram));
+}
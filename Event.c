@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * File: StCore\Event.c
+ * Author: agent
+ * Date: 2026-10-17
+*******************************************************************************/
+
+#include "Main.h"
+
+/* Get command completion events */
+long StCoreGetCommandEvents(StCoreCommandEventType *pEvents, unsigned short Size, unsigned long *Cursor) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.commandEvents
+	************************************************/
+	
+	/***********************
+	 Declare Local Variables
+	***********************/
+	unsigned long write, start, count;
+	
+	/******
+	 Verify
+	******/
+	/* Check references */
+	if(pEvents == NULL || Cursor == NULL)
+		return stCORE_ERROR_ALLOCATION;
+	
+	/* Move to the oldest event if the cursor has been overwritten */
+	write = core.commandEvents.write;
+	__sync_synchronize();
+	if(write - *Cursor > CORE_COMMAND_EVENT_COUNT) {
+		*Cursor = write > CORE_COMMAND_EVENT_COUNT ? write - CORE_COMMAND_EVENT_COUNT : 0;
+		return stCORE_WARNING_COMMAND_EVENT;
+	}
+	
+	/****
+	 Copy
+	****/
+	start = *Cursor;
+	for(count = 0; count < Size && start + count != write; count++)
+		memcpy(pEvents + count, &core.commandEvents.event[(start + count) % CORE_COMMAND_EVENT_COUNT], sizeof(*pEvents));
+	
+	/* StCoreCyclic may interrupt the copy, discard if the first event copied has since been overwritten */
+	__sync_synchronize();
+	write = core.commandEvents.write;
+	if(write - start > CORE_COMMAND_EVENT_COUNT) {
+		*Cursor = write - CORE_COMMAND_EVENT_COUNT;
+		return stCORE_WARNING_COMMAND_EVENT;
+	}
+	
+	*Cursor = start + count;
+	return (long)count;
+	
+} /* End function */
+
+/* Write command completion event to the ring buffer */
+void coreCommandEvent(coreCommandType *pCommand, coreCommandSelectEnum select, long result, unsigned long latency) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.commandEvents (w)
+	   core.pSimpleRelease
+	   core.cycleCount
+	  Subroutines:
+	   coreCommandHandle
+	************************************************/
+	
+	/* Declare local variables */
+	StCoreCommandEventType *pEvent;
+	
+	pEvent = &core.commandEvents.event[core.commandEvents.write % CORE_COMMAND_EVENT_COUNT];
+	pEvent->Sequence = core.commandEvents.write;
+	pEvent->Cycle = core.cycleCount;
+	pEvent->Handle = coreCommandHandle(pCommand);
+	pEvent->Instance = (unsigned long)pCommand->pInstance;
+	pEvent->Command = (unsigned char)select;
+	pEvent->CommandID = pCommand->command.u1[0];
+	if(select == CORE_COMMAND_SIMPLE)
+		pEvent->Context = (unsigned char)(pCommand - core.pSimpleRelease + 1); /* One simple release per target */
+	else
+		pEvent->Context = pCommand->command.u1[1];
+	pEvent->Result = result;
+	pEvent->Latency = latency;
+	
+	/* Complete the event before it is visible to readers */
+	__sync_synchronize();
+	core.commandEvents.write++;
+	
+} /* End function */
@@ -35,11 +35,31 @@ long StCoreExit(void) {
 		TMP_free(allocationSize, (void**)core.pCommandBuffer);
 	}
 	
+	if(core.commandPool.pNode) {
+		allocationSize = sizeof(coreCommandType) * core.commandPool.size;
+		TMP_free(allocationSize, (void**)core.commandPool.pNode);
+	}
+	
+	if(core.commandPool.pCell) {
+		allocationSize = sizeof(coreCommandCellType) * (core.commandPool.mask + 1);
+		TMP_free(allocationSize, (void**)core.commandPool.pCell);
+	}
+	
 	if(core.pPalletData) {
 		allocationSize = sizeof(SuperTrakPalletInfo_t) * core.palletCount;
 		TMP_free(allocationSize, (void**)core.pPalletData);
 	}
 	
+	if(core.snapshot.pCyclicStatus) {
+		allocationSize = core.interface.statusSize;
+		TMP_free(allocationSize, (void**)core.snapshot.pCyclicStatus);
+	}
+	
+	if(core.snapshot.pPalletData) {
+		allocationSize = sizeof(SuperTrakPalletInfo_t) * core.palletCount;
+		TMP_free(allocationSize, (void**)core.snapshot.pPalletData);
+	}
+	
 	coreLog(core.ident, CORE_LOG_SEVERITY_INFO, CORE_LOGBOOK_FACILITY, 1300, "Exit", "Allocated memory is free", NULL);
 	
 	return 0;
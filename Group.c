@@ -0,0 +1,346 @@
+/*******************************************************************************
+ * File: StCore\Group.c
+ * Author: agent
+ * Date: 2026-10-17
+*******************************************************************************/
+
+#include "Main.h"
+#define LOG_OBJECT "Group"
+
+/* Prototypes */
+static long logMessage(coreLogSeverityEnum severity, unsigned short code, char *message, coreFormatArgumentType *args);
+
+/* Submit commands for one pallet sent in the same frame in array order, returns the group handle or a negative status */
+long StCoreCommandGroup(StCoreCommandType *pCommands, unsigned short Count) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.pCommandBuffer (w)
+	   core.commandPool
+	   core.commandPallets (w)
+	   core.commandCount
+	   core.error
+	   core.statusID
+	  Subroutines:
+	   logMessage
+	   coreCommandBuild
+	   coreCommandReserve
+	   coreCommandUnreserve
+	   coreCommandHandle
+	************************************************/
+	
+	/***********************
+	 Declare Local Variables
+	***********************/
+	SuperTrakCommand_t data[CORE_COMMAND_GROUP_MAX];
+	coreCommandType *pCommand[CORE_COMMAND_GROUP_MAX];
+	unsigned char index[CORE_COMMAND_GROUP_MAX];
+	coreCommandBufferType *pBuffer;
+	coreFormatArgumentType args;
+	unsigned long node, inbox, handle;
+	unsigned short i, j;
+	long status;
+	
+	/**********
+	 Check Core
+	**********/
+	/* Check cyclic core */
+	if(core.error) {
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(core.statusID), "Command group aborted due to critical error in StCore", NULL);
+		return core.statusID;
+	}
+	
+	/* Check reference */
+	if(core.pCommandBuffer == NULL) {
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_ALLOCATION), "Command group cannot reference command buffer", NULL);
+		return stCORE_ERROR_ALLOCATION;
+	}
+	
+	/* Check inputs, every member needs its own channel in the same frame */
+	if(pCommands == NULL || Count < 2 || Count > CORE_COMMAND_GROUP_MAX || Count > core.commandCount) {
+		args.i[0] = Count;
+		args.i[1] = MIN(CORE_COMMAND_GROUP_MAX, core.commandCount);
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_GROUP), "Command group of %i commands exceeds limits [2, %i]", &args);
+		return stCORE_ERROR_GROUP;
+	}
+	
+	/****************
+	 Validate Members
+	****************/
+	for(i = 0; i < Count; i++) {
+		status = coreCommandBuild(pCommands + i, &index[i], &data[i]);
+		if(status)
+			return status;
+		if(index[i] != index[0]) {
+			args.i[0] = i;
+			args.i[1] = index[i];
+			args.i[2] = index[0];
+			logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_GROUP), "Command group member %i for pallet buffer %i differs from pallet buffer %i of the group", &args);
+			return stCORE_ERROR_GROUP;
+		}
+	}
+	
+	/****************
+	 Reserve Members
+	****************/
+	/* All or nothing, return every reservation so far if one is rejected */
+	for(i = 0; i < Count; i++) {
+		status = coreCommandReserve(index[0], &pCommand[i], NULL);
+		if(status) {
+			for(j = 0; j < i; j++)
+				coreCommandUnreserve(index[0], pCommand[j]);
+			args.i[0] = index[0];
+			args.i[1] = Count;
+			args.i[2] = (long)core.commandPool.used;
+			args.i[3] = (long)core.commandPool.size;
+			logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(status), "Command group for pallet buffer %i of %i commands rejected because buffer is full (%i of %i pooled commands in use)", &args);
+			return status;
+		}
+	}
+	
+	/**************
+	 Publish Group
+	**************/
+	/* Write each member, only the first member (leader) may be cancelled or replaced and it holds the group size */
+	handle = coreCommandHandle(pCommand[0]);
+	for(i = 0; i < Count; i++) {
+		memcpy(&pCommand[i]->command, &data[i], sizeof(pCommand[i]->command));
+		pCommand[i]->pInstance = NULL;
+		pCommand[i]->requested = (unsigned long)AsIOTimeStamp();
+		pCommand[i]->attempt = 0;
+		pCommand[i]->index = index[0];
+		pCommand[i]->group = i == 0 ? (unsigned char)Count : 0;
+		pCommand[i]->claim = i == 0 ? handle : 0;
+		pCommand[i]->status = 1U << CORE_COMMAND_PENDING;
+	}
+	
+	/* Link the members newest first, as the inbox is, and push them at once so no other request lands between them */
+	for(i = Count - 1; i > 0; i--)
+		pCommand[i]->next = (unsigned short)(pCommand[i - 1] - core.commandPool.pNode + 1);
+	pBuffer = core.pCommandBuffer + index[0] - 1;
+	node = (unsigned long)(pCommand[Count - 1] - core.commandPool.pNode) + 1;
+	__sync_synchronize(); /* Publish after the members are written */
+	do {
+		inbox = pBuffer->inbox;
+		pCommand[0]->next = (unsigned short)inbox;
+	} while(!__sync_bool_compare_and_swap(&pBuffer->inbox, inbox, node));
+	SET_BITMAP_ATOMIC(core.commandPallets, index[0] - 1); /* Wake the command manager for this pallet */
+	
+	args.i[0] = Count;
+	args.i[1] = index[0];
+	logMessage(CORE_LOG_SEVERITY_DEBUG, 4200, "Command group request of %i commands for pallet buffer %i", &args);
+	
+	return (long)handle;
+	
+} /* End function */
+
+/* Submit a command group on rising edge of Execute and follow it to completion */
+void StCoreGroup(StCoreGroup_typ *inst) {
+	
+	/************************************************
+	 Dependencies:
+	  Subroutines:
+	   StCoreCommandGroup
+	   StCoreCommandStatus
+	************************************************/
+	
+	/* Declare local variables */
+	long status;
+	
+	if(inst->Execute && !GET_BIT(inst->Internal.PreviousCommand, 0)) {
+		status = StCoreCommandGroup(inst->pCommands, inst->Count);
+		inst->Done = false;
+		inst->Error = status < 0;
+		inst->StatusID = status < 0 ? status : 0;
+		inst->Busy = status > 0;
+		inst->Internal.Handle[0] = status > 0 ? (unsigned long)status : 0;
+	}
+	else if(!inst->Execute) {
+		inst->Busy = false;
+		inst->Done = false;
+		inst->Error = false;
+		inst->StatusID = 0;
+		inst->Internal.Handle[0] = 0;
+	}
+	
+	/* Follow the group handle until the group completes */
+	if(inst->Busy) {
+		status = StCoreCommandStatus(inst->Internal.Handle[0]);
+		if(status == stCORE_COMMAND_STATE_DONE) {
+			inst->Busy = false;
+			inst->Done = true;
+		}
+		else if(status == stCORE_COMMAND_STATE_CANCELLED) {
+			inst->Busy = false;
+			inst->Done = true;
+			inst->StatusID = stCORE_WARNING_CANCELLED;
+		}
+		else if(status != stCORE_COMMAND_STATE_PENDING && status != stCORE_COMMAND_STATE_BUSY) {
+			inst->Busy = false;
+			inst->Error = true;
+			inst->StatusID = status == stCORE_COMMAND_STATE_ERROR ? stCORE_ERROR_COMMAND : status < 0 ? status : stCORE_ERROR_ACKNOWLEDGE;
+		}
+	}
+	
+	coreAssign16(&inst->Internal.PreviousCommand, 0, inst->Execute);
+	
+} /* End function */
+
+/* Write every member of the pending group to free channels in ascending order, return the member count, -1 to pause other pallet buffers, -2 if the requester holds the group, or -3 to wait for more free channels */
+long coreGroupAssign(coreCommandBufferType *pBuffer, coreCommandType *pLeader) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.pCyclicControl (w)
+	   core.channels (rw)
+	   core.commandPool
+	   core.commandCount
+	  Subroutines:
+	   logMessage
+	   coreBitmapFind
+	   coreCommandTake
+	   coreCommandSelect
+	   coreCommandAssigned
+	   coreDeadlineStartChannel
+	************************************************/
+	
+	/* Declare local variables */
+	coreCommandChannelType *pChannels = &core.channels;
+	unsigned long free[BITMAP_WORDS(CORE_COMMAND_MAX)];
+	long channel[CORE_COMMAND_GROUP_MAX];
+	coreFormatArgumentType args;
+	coreCommandType *pMember;
+	unsigned char i;
+	
+	/* Find the lowest free channels so members are sent in channel order, which SuperTrak processes in ascending order */
+	memcpy(free, pChannels->free, sizeof(free));
+	for(i = 0; i < pLeader->group; i++) {
+		channel[i] = coreBitmapFind(free, core.commandCount, 0);
+		if(channel[i] < 0)
+			break;
+		CLEAR_BITMAP(free, channel[i]);
+	}
+	
+	/* Too few channels, other pallet buffers take the free channels until the group has waited too long */
+	if(i < pLeader->group) {
+		if(i == 0)
+			return -1; /* All channels are busy */
+		if(pBuffer->waiting < CORE_COMMAND_GROUP_HOLD)
+			return -3;
+		
+		/* Hold the free channels, the paused manager starts with this pallet buffer next cycle */
+		if(pBuffer->waiting == CORE_COMMAND_GROUP_HOLD) {
+			args.i[0] = pLeader->index;
+			args.i[1] = pLeader->group;
+			args.i[2] = i;
+			logMessage(CORE_LOG_SEVERITY_DEBUG, 4200, "Pallet buffer %i command group of %i commands holds channels with %i free", &args);
+		}
+		return -1;
+	}
+	
+	/* Take the group from cancel and replace */
+	if(!coreCommandTake(pLeader))
+		return -2;
+	
+	/* Write all members in this cycle so they reach SuperTrak in the same frame */
+	pMember = pLeader;
+	for(i = 0; i < pLeader->group; i++) {
+		memcpy((SuperTrakCommand_t*)(core.pCyclicControl + core.interface.commandDataOffset) + channel[i], &pMember->command, sizeof(SuperTrakCommand_t));
+		pMember->channel = (unsigned char)channel[i];
+		pMember->status = 1U << CORE_COMMAND_BUSY;
+		coreCommandAssigned(pMember, coreCommandSelect(pMember->command.u1[0]));
+		coreDeadlineStartChannel((unsigned char)channel[i], coreCommandSelect(pMember->command.u1[0]));
+		CLEAR_BITMAP(pChannels->free, channel[i]);
+		pMember = core.commandPool.pNode + pMember->next - 1;
+	}
+	pLeader->result = 0;
+	pBuffer->waiting = 0;
+	
+	return pLeader->group;
+	
+} /* End function */
+
+/* Record responses of the busy group, returns true once every member is done and the group may be dequeued */
+unsigned char coreGroupMonitor(coreCommandType *pLeader, unsigned long *pExpired, unsigned long *pReleased) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.pCyclicControl (w)
+	   core.pCyclicStatus
+	   core.interface
+	   core.commandPool
+	  Subroutines:
+	   logMessage
+	   coreCommandSelect
+	   coreCommandFinished
+	   coreDeadlineCancelChannel
+	************************************************/
+	
+	/* Declare local variables */
+	coreCommandType *pMember;
+	unsigned char *pStatus, complete, success, i, done;
+	coreFormatArgumentType args;
+	long result;
+	
+	done = true;
+	pMember = pLeader;
+	for(i = 0; i < pLeader->group; pMember = core.commandPool.pNode + pMember->next - 1, i++) {
+		/* Member already done */
+		if(pMember->channel >= CORE_COMMAND_MAX)
+			continue;
+		
+		pStatus = core.pCyclicStatus + core.interface.commandStatusOffset + pMember->channel / CORE_COMMAND_STATUS_PER_BYTE;
+		complete = GET_BIT(*pStatus, (pMember->channel % CORE_COMMAND_STATUS_PER_BYTE) * CORE_COMMAND_STATUS_BIT_COUNT);
+		success = GET_BIT(*pStatus, (pMember->channel % CORE_COMMAND_STATUS_PER_BYTE) * CORE_COMMAND_STATUS_BIT_COUNT + 1);
+		
+		if(complete) {
+			result = success ? 0 : stCORE_ERROR_COMMAND;
+			coreDeadlineCancelChannel(pMember->channel);
+		}
+		else if(GET_BITMAP(pExpired, pMember->channel))
+			result = stCORE_ERROR_TIMEOUT;
+		else {
+			done = false;
+			continue;
+		}
+		
+		if(result) {
+			args.i[0] = pLeader->index;
+			args.i[1] = i;
+			args.i[2] = pMember->command.u1[0];
+			logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(result), "Pallet buffer %i command group member %i (command ID %i) failed or timed out", &args);
+			if(pLeader->result == 0)
+				pLeader->result = result;
+		}
+		
+		/* Clear cyclic data and release the channel next cycle */
+		memset((SuperTrakCommand_t*)(core.pCyclicControl + core.interface.commandDataOffset) + pMember->channel, 0, sizeof(SuperTrakCommand_t));
+		SET_BITMAP(pReleased, pMember->channel);
+		pMember->channel = CORE_COMMAND_MAX;
+		
+		/* The leader reports the group, the other members report themselves */
+		if(pMember != pLeader)
+			pMember->status = result ? 1U << CORE_COMMAND_DONE | 1U << CORE_COMMAND_ERROR : 1U << CORE_COMMAND_DONE;
+		coreCommandFinished(pMember, coreCommandSelect(pMember->command.u1[0]), result);
+	}
+	
+	if(!done)
+		return false;
+	
+	args.i[0] = pLeader->index;
+	args.i[1] = pLeader->group;
+	if(pLeader->result == 0)
+		logMessage(CORE_LOG_SEVERITY_DEBUG, 4300, "Pallet buffer %i command group of %i commands acknowledged", &args);
+	pLeader->status = pLeader->result ? 1U << CORE_COMMAND_DONE | 1U << CORE_COMMAND_ERROR : 1U << CORE_COMMAND_DONE;
+	
+	return true;
+	
+} /* End function */
+
+/* Create local logging function */
+long logMessage(coreLogSeverityEnum severity, unsigned short code, char *message, coreFormatArgumentType *args) {
+	return coreLog(core.ident, severity, CORE_LOGBOOK_FACILITY, code, LOG_OBJECT, message, args);
+}
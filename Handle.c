@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * File: StCore\Handle.c
+ * Author: agent
+ * Date: 2026-10-17
+*******************************************************************************/
+
+#include "Main.h"
+
+/* Get the state of a command from its handle */
+long StCoreCommandStatus(unsigned long Handle) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.commandPool
+	   core.pSimpleRelease
+	   core.targetCount
+	  Subroutines:
+	   coreCommandSlot
+	   coreCommandStatus
+	************************************************/
+	
+	/* Declare local variables */
+	unsigned char status;
+	
+	if(core.commandPool.pNode == NULL || core.pSimpleRelease == NULL)
+		return stCORE_ERROR_ALLOCATION;
+	
+	if(coreCommandSlot(Handle) == NULL)
+		return stCORE_ERROR_HANDLE;
+	
+	/* The command has been reused, its result remains in the command events */
+	if(!coreCommandStatus(Handle, &status))
+		return stCORE_COMMAND_STATE_EXPIRED;
+	
+	if(GET_BIT(status, CORE_COMMAND_DONE)) {
+		if(GET_BIT(status, CORE_COMMAND_ERROR))
+			return stCORE_COMMAND_STATE_ERROR;
+		if(GET_BIT(status, CORE_COMMAND_SUPERSEDED))
+			return stCORE_COMMAND_STATE_SUPERSEDED;
+		if(GET_BIT(status, CORE_COMMAND_CANCELLED))
+			return stCORE_COMMAND_STATE_CANCELLED;
+		return stCORE_COMMAND_STATE_DONE;
+	}
+	if(GET_BIT(status, CORE_COMMAND_BUSY))
+		return stCORE_COMMAND_STATE_BUSY;
+	
+	return stCORE_COMMAND_STATE_PENDING;
+	
+} /* End function */
+
+/* Start a new use of a command owned by the caller, handles to the previous use expire */
+void coreCommandGeneration(coreCommandType *pCommand) {
+	pCommand->generation = pCommand->generation % CORE_COMMAND_GENERATION_MAX + 1; /* Never 0 so no handle is 0 */
+	__sync_synchronize();
+}
+
+/* Get the handle of the current use of a command */
+unsigned long coreCommandHandle(coreCommandType *pCommand) {
+	
+	/* Declare local variables */
+	unsigned long slot;
+	
+	if(core.pSimpleRelease != NULL && core.pSimpleRelease <= pCommand && pCommand < core.pSimpleRelease + core.targetCount)
+		slot = CORE_COMMAND_POOL_MAX + (unsigned long)(pCommand - core.pSimpleRelease);
+	else
+		slot = (unsigned long)(pCommand - core.commandPool.pNode);
+	
+	return pCommand->generation << CORE_COMMAND_HANDLE_SLOT_BITS | slot;
+}
+
+/* Read the status byte of the command, returns false if the handle is invalid or the command has been reused */
+unsigned char coreCommandStatus(unsigned long handle, unsigned char *pStatus) {
+	
+	/* Declare local variables */
+	coreCommandType *pCommand;
+	unsigned long generation;
+	
+	pCommand = coreCommandSlot(handle);
+	if(pCommand == NULL)
+		return false;
+	
+	/* Confirm the generation before and after reading the status, any request may reuse the command meanwhile */
+	generation = handle >> CORE_COMMAND_HANDLE_SLOT_BITS;
+	if(pCommand->generation != generation)
+		return false;
+	__sync_synchronize();
+	*pStatus = pCommand->status;
+	__sync_synchronize();
+	if(pCommand->generation != generation)
+		return false;
+	
+	/* A reserved command is being written by a new request */
+	if(GET_BIT(*pStatus, CORE_COMMAND_RESERVED))
+		return false;
+	
+	return true;
+}
+
+/* Find the command selected by the handle, NULL if the handle cannot be valid */
+coreCommandType* coreCommandSlot(unsigned long handle) {
+	
+	/* Declare local variables */
+	unsigned long slot;
+	
+	slot = handle & ((1UL << CORE_COMMAND_HANDLE_SLOT_BITS) - 1);
+	if((handle >> CORE_COMMAND_HANDLE_SLOT_BITS) == 0 || (handle >> CORE_COMMAND_HANDLE_SLOT_BITS) > CORE_COMMAND_GENERATION_MAX)
+		return NULL;
+	
+	if(slot < CORE_COMMAND_POOL_MAX) {
+		if(core.commandPool.pNode == NULL || slot >= core.commandPool.size)
+			return NULL;
+		return core.commandPool.pNode + slot;
+	}
+	
+	slot -= CORE_COMMAND_POOL_MAX;
+	if(core.pSimpleRelease == NULL || slot >= core.targetCount)
+		return NULL;
+	return core.pSimpleRelease + slot;
+}
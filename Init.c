@@ -9,6 +9,7 @@
 
 /* Prototypes */
 static long logMessage(coreLogSeverityEnum severity, unsigned short code, char *message, coreFormatArgumentType *args);
+static void applyOptions(StCoreOptionsType *pOptions);
 void logMemoryManagement(unsigned short result, unsigned long size, char *name);
 
 /* Global variable declaration */
@@ -18,18 +19,21 @@ struct coreGlobalType core = {.error = true, .statusID = stCORE_ERROR_INITIALIZA
  StCoreInit definition
 *********************/
 /* Initialize SuperTrak, verify layout, read targets, and size control interface */
-long StCoreInit(char *StoragePath, char *SimIPAddress, char *EthernetInterfaceList, unsigned char PalletCount, unsigned char NetworkIOCount) {
+long StCoreInit(char *StoragePath, char *SimIPAddress, char *EthernetInterfaceList, unsigned char PalletCount, unsigned char NetworkIOCount, unsigned char CommandCount, StCoreOptionsType *pOptions) {
 	
 	/************************************************
 	 Dependencies:
 	  Global:
 	   Writes to all global variables except
-	    core.palletMap
+	    core.palletEvents
+	    core.palletChanges
+	    core.commandEvents
 		core.ready
 		core.debug
 	  Subroutines:
 	   logMessage
 	   logMemoryManagement
+	   applyOptions
 	************************************************/
 	
 	/***********************
@@ -41,7 +45,7 @@ long StCoreInit(char *StoragePath, char *SimIPAddress, char *EthernetInterfaceLi
 	coreFormatArgumentType args;
 	unsigned short sectionCount, networkOrder[CORE_SECTION_MAX], headSection, flowDirection;
 	unsigned short targetSection[CORE_TARGET_MAX];
-	unsigned long allocationSize;
+	unsigned long allocationSize, cellCount;
 	
 	/********************
 	 Initialize SuperTrak
@@ -146,8 +150,9 @@ long StCoreInit(char *StoragePath, char *SimIPAddress, char *EthernetInterfaceLi
 		return core.statusID = stCORE_ERROR_PARAMETER;
 	}
 	
-	/* Clear mapping table */
+	/* Clear mapping tables */
 	memset(&core.sectionMap, -1, sizeof(core.sectionMap));
+	memset(&core.sectionAddress, 0, sizeof(core.sectionAddress));
 	
 	/* Find the head in user addresses */
 	for(i = 0; i < sectionCount; i++) {
@@ -161,8 +166,9 @@ long StCoreInit(char *StoragePath, char *SimIPAddress, char *EthernetInterfaceLi
 				return core.statusID = stCORE_ERROR_LAYOUT;
 			}
 			
-			/* Register in mapping table */
+			/* Register in mapping tables */
 			core.sectionMap[networkOrder[i]] = 0;
+			core.sectionAddress[0] = (unsigned char)networkOrder[i];
 			
 			/* Adjust index in flow direction */
 			if(flowDirection == stDIRECTION_RIGHT) {
@@ -194,7 +200,8 @@ long StCoreInit(char *StoragePath, char *SimIPAddress, char *EthernetInterfaceLi
 			return core.statusID = stCORE_ERROR_LAYOUT;
 		}
 		
-		/* Register in mapping table */
+		/* Register in mapping tables */
+		core.sectionAddress[j] = (unsigned char)networkOrder[i];
 		core.sectionMap[networkOrder[i]] = j++;
 		
 		/* Adjust index in flow direction */
@@ -228,6 +235,63 @@ long StCoreInit(char *StoragePath, char *SimIPAddress, char *EthernetInterfaceLi
 	*******************************/
 	core.palletCount = PalletCount;
 	core.networkIOCount = NetworkIOCount;
+	core.commandCount = CommandCount ? CommandCount : CORE_COMMAND_COUNT;
+	applyOptions(pOptions);
+	
+	/* Verify command count against the protocol limit */
+	if(CORE_COMMAND_MAX < core.commandCount) {
+		args.i[0] = core.commandCount;
+		args.i[1] = CORE_COMMAND_MAX;
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_INPUT), "Command count %i exceeds limits [0, %i] (0 for default)", &args);
+		return core.statusID = stCORE_ERROR_INPUT;
+	}
+	
+	/* Verify command pool size */
+	if(CORE_COMMAND_POOL_MAX < core.options.Command.PoolSize) {
+		args.i[0] = core.options.Command.PoolSize;
+		args.i[1] = CORE_COMMAND_POOL_MAX;
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_INPUT), "Command pool size %i exceeds limits [0, %i] (0 for default)", &args);
+		return core.statusID = stCORE_ERROR_INPUT;
+	}
+	
+	/* Verify command scheduler */
+	if(core.options.Command.Scheduler > stCORE_SCHEDULER_PRIORITY) {
+		args.i[0] = core.options.Command.Scheduler;
+		args.i[1] = stCORE_SCHEDULER_PRIORITY;
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_INPUT), "Command scheduler %i exceeds limits [0, %i]", &args);
+		return core.statusID = stCORE_ERROR_INPUT;
+	}
+	if(CORE_COMMAND_AGING_MAX < core.options.Command.AgingTime) {
+		args.i[0] = (long)core.options.Command.AgingTime;
+		args.i[1] = CORE_COMMAND_AGING_MAX;
+		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_INPUT), "Command aging time %i ms exceeds limits [0, %i] (0 for default)", &args);
+		return core.statusID = stCORE_ERROR_INPUT;
+	}
+	
+	/* Verify adaptive command timeouts and retry policies */
+	for(i = 0; i < CORE_COMMAND_SELECT_COUNT; i++) {
+		if(CORE_COMMAND_TIMEOUT_MAX < core.options.Command.Timeout[i].Ceiling) {
+			args.i[0] = i;
+			args.i[1] = (long)core.options.Command.Timeout[i].Ceiling;
+			args.i[2] = CORE_COMMAND_TIMEOUT_MAX;
+			logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_INPUT), "Command %i timeout ceiling %i ms exceeds limits [0, %i] (0 for default)", &args);
+			return core.statusID = stCORE_ERROR_INPUT;
+		}
+		if(core.options.Command.Timeout[i].Ceiling < core.options.Command.Timeout[i].Floor) {
+			args.i[0] = i;
+			args.i[1] = (long)core.options.Command.Timeout[i].Floor;
+			args.i[2] = (long)core.options.Command.Timeout[i].Ceiling;
+			logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_INPUT), "Command %i timeout floor %i ms exceeds ceiling %i ms", &args);
+			return core.statusID = stCORE_ERROR_INPUT;
+		}
+		if(core.options.Command.Retry[i].Attempts > CORE_COMMAND_RETRY_MAX) {
+			args.i[0] = i;
+			args.i[1] = core.options.Command.Retry[i].Attempts;
+			args.i[2] = CORE_COMMAND_RETRY_MAX;
+			logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_INPUT), "Command %i retry attempts %i exceeds limits [0, %i]", &args);
+			return core.statusID = stCORE_ERROR_INPUT;
+		}
+	}
 	
 	/* Options */
 	/* Enable interface (0) and use system control & status */
@@ -272,7 +336,7 @@ long StCoreInit(char *StoragePath, char *SimIPAddress, char *EthernetInterfaceLi
 	}
 	
 	/* Command count */
-	core.interface.commandCount = ROUND_UP_MULTIPLE(CORE_COMMAND_COUNT, CORE_COMMAND_DATA_BYTE_COUNT);
+	core.interface.commandCount = ROUND_UP_MULTIPLE(core.commandCount, CORE_COMMAND_DATA_BYTE_COUNT);
 	status = SuperTrakServChanWrite(0, stPAR_PLC_IF_COMMAND_COUNT, 0, 1, (unsigned long)&core.interface.commandCount, sizeof(core.interface.commandCount));
 	if(status != scERR_SUCCESS) {
 		coreLogServiceChannel((unsigned short)status, stPAR_PLC_IF_COMMAND_COUNT, LOG_OBJECT);
@@ -352,6 +416,48 @@ long StCoreInit(char *StoragePath, char *SimIPAddress, char *EthernetInterfaceLi
 		return stCORE_ERROR_ALLOCATION;
 	}
 	memset(core.pCommandBuffer, 0, allocationSize); /* Initialization memory to zero */
+	memset((void*)core.commandPallets, 0, sizeof(core.commandPallets));
+	memset((void*)core.commandTargets, 0, sizeof(core.commandTargets));
+	memset(&core.channels, 0, sizeof(core.channels));
+	for(i = 0; i < core.commandCount; i++)
+		SET_BITMAP(core.channels.free, i);
+	memset(&core.commandTimeouts, 0, sizeof(core.commandTimeouts));
+	
+	/* Memory for the shared command pool, free with the previous sizes */
+	if(core.commandPool.pNode)
+		TMP_free(sizeof(coreCommandType) * core.commandPool.size, (void**)core.commandPool.pNode);
+	if(core.commandPool.pCell)
+		TMP_free(sizeof(coreCommandCellType) * (core.commandPool.mask + 1), (void**)core.commandPool.pCell);
+	memset(&core.commandPool, 0, sizeof(core.commandPool));
+	
+	allocationSize = sizeof(coreCommandType) * core.options.Command.PoolSize;
+	status = TMP_alloc(allocationSize, (void**)&core.commandPool.pNode);
+	if(status) {
+		logMemoryManagement((unsigned short)status, allocationSize, "command pool");
+		return stCORE_ERROR_ALLOCATION;
+	}
+	memset(core.commandPool.pNode, 0, allocationSize);
+	
+	/* The free queue has a power of two cells */
+	for(cellCount = 1; cellCount < core.options.Command.PoolSize; cellCount <<= 1);
+	allocationSize = sizeof(coreCommandCellType) * cellCount;
+	status = TMP_alloc(allocationSize, (void**)&core.commandPool.pCell);
+	if(status) {
+		TMP_free(sizeof(coreCommandType) * core.options.Command.PoolSize, (void**)core.commandPool.pNode);
+		core.commandPool.pNode = NULL;
+		logMemoryManagement((unsigned short)status, allocationSize, "command pool queue");
+		return stCORE_ERROR_ALLOCATION;
+	}
+	
+	/* Every node starts in the free queue */
+	core.commandPool.size = core.options.Command.PoolSize;
+	core.commandPool.mask = cellCount - 1;
+	core.commandPool.palletCap = core.options.Command.PalletCap;
+	for(i = 0; i < cellCount; i++) {
+		core.commandPool.pCell[i].node = i;
+		core.commandPool.pCell[i].sequence = i < core.commandPool.size ? i + 1 : i;
+	}
+	core.commandPool.enqueue = core.commandPool.size;
 	
 	/* Memory for pallet information */
 	allocationSize = sizeof(SuperTrakPalletInfo_t) * MAX(core.palletCount, 1);
@@ -364,6 +470,38 @@ long StCoreInit(char *StoragePath, char *SimIPAddress, char *EthernetInterfaceLi
 	}
 	memset(core.pPalletData, 0, allocationSize);
 	
+	/* Memory for status snapshot */
+	if(core.options.Snapshot) {
+		allocationSize = core.interface.statusSize;
+		if(core.snapshot.pCyclicStatus)
+			TMP_free(allocationSize, (void**)core.snapshot.pCyclicStatus);
+		status = TMP_alloc(allocationSize, (void**)&core.snapshot.pCyclicStatus);
+		if(status) {
+			logMemoryManagement((unsigned short)status, allocationSize, "cyclic status snapshot");
+			return stCORE_ERROR_ALLOCATION;
+		}
+		memset(core.snapshot.pCyclicStatus, 0, allocationSize);
+		
+		allocationSize = sizeof(SuperTrakPalletInfo_t) * MAX(core.palletCount, 1);
+		if(core.snapshot.pPalletData)
+			TMP_free(allocationSize, (void**)core.snapshot.pPalletData);
+		status = TMP_alloc(allocationSize, (void**)&core.snapshot.pPalletData);
+		if(status) {
+			logMemoryManagement((unsigned short)status, allocationSize, "pallet status snapshot");
+			return stCORE_ERROR_ALLOCATION;
+		}
+		memset(core.snapshot.pPalletData, 0, allocationSize);
+		memset(&core.snapshot.palletMap, -1, sizeof(core.snapshot.palletMap));
+	}
+	
+	/* Pallet mapping is updated from changes to the cleared pallet information */
+	memset(&core.palletMap, -1, sizeof(core.palletMap));
+	memset(&core.palletPrevious, 0, sizeof(core.palletPrevious));
+	
+	/* Read all parameters again with the new configuration */
+	memset(&core.parameters, 0, sizeof(core.parameters));
+	memset(&core.telemetry, 0, sizeof(core.telemetry));
+	
 	args.i[0] = sectionCount;
 	args.i[1] = core.targetCount;
 	logMessage(CORE_LOG_SEVERITY_SUCCESS, 1200, "%i sections and %i targets defined in TrakMaster", &args);
@@ -377,6 +515,51 @@ long logMessage(coreLogSeverityEnum severity, unsigned short code, char *message
 	return coreLog(core.ident, severity, CORE_LOGBOOK_FACILITY, code, LOG_OBJECT, message, args);
 }
 
+/* Copy user options and apply defaults to zero values */
+void applyOptions(StCoreOptionsType *pOptions) {
+	
+	/* Declare local variables */
+	unsigned char i;
+	
+	if(pOptions)
+		memcpy(&core.options, pOptions, sizeof(core.options));
+	else
+		memset(&core.options, 0, sizeof(core.options));
+	
+	/* Fault monitor */
+	if(core.options.FaultMonitor.ReadBudget == 0)
+		core.options.FaultMonitor.ReadBudget = CORE_FAULT_READ_BUDGET;
+	if(core.options.FaultMonitor.SweepPeriod == 0)
+		core.options.FaultMonitor.SweepPeriod = CORE_FAULT_SWEEP_PERIOD;
+	
+	/* Parameter cache, pallet, target, and fault parameters default to every scan */
+	if(core.options.Parameter.Power == 0)
+		core.options.Parameter.Power = CORE_PARAMETER_PERIOD;
+	
+	/* Section telemetry */
+	if(core.options.Telemetry.ReadBudget == 0)
+		core.options.Telemetry.ReadBudget = CORE_TELEMETRY_READ_BUDGET;
+	
+	/* Command pool */
+	if(core.options.Command.PoolSize == 0)
+		core.options.Command.PoolSize = MAX(core.palletCount * CORE_COMMAND_POOL_PER_PALLET, CORE_COMMAND_BUFFER_SIZE);
+	if(core.options.Command.PalletCap == 0)
+		core.options.Command.PalletCap = CORE_COMMAND_BUFFER_SIZE;
+	if(core.options.Command.AgingTime == 0)
+		core.options.Command.AgingTime = CORE_COMMAND_AGING_TIME;
+	
+	/* Adaptive command timeouts */
+	for(i = 0; i < CORE_COMMAND_SELECT_COUNT; i++) {
+		if(core.options.Command.Timeout[i].Ceiling == 0)
+			core.options.Command.Timeout[i].Ceiling = CORE_COMMAND_TIMEOUT / 1000;
+		if(core.options.Command.Timeout[i].Floor == 0) /* A default floor never exceeds a small ceiling */
+			core.options.Command.Timeout[i].Floor = MIN(CORE_COMMAND_TIMEOUT_FLOOR, core.options.Command.Timeout[i].Ceiling);
+		if(core.options.Command.Timeout[i].Factor <= 0.0)
+			core.options.Command.Timeout[i].Factor = CORE_COMMAND_TIMEOUT_FACTOR;
+	}
+	
+} /* End function */
+
 /* Log error from memory management (TMP_alloc) calls */
 void logMemoryManagement(unsigned short result, unsigned long size, char *name) {
 	
@@ -6,6 +6,11 @@
 
 #include "Main.h"
 
+/* Prototypes */
+static void logSuperTrakFault(unsigned char section, unsigned char instance);
+static long readFaultInstances(unsigned char context, unsigned short *pInstanceLog);
+static long writeRecord(coreLogRecordType *pRecord);
+
 /* Safely copy a string */
 char* coreStringCopy(char *destination, const char *source, unsigned long size) {
 	destination[size - 1] = '\0'; /* Ensure null terminator */
@@ -83,9 +88,17 @@ unsigned long coreFormat(char *str, unsigned long size, char *format, coreFormat
 /* Log messages to the library's logbook with ArEventLog */
 long coreLog(ArEventLogIdentType ident, coreLogSeverityEnum severity, unsigned char facility, unsigned short code, char *object, char *message, coreFormatArgumentType *args) {
 
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.debug
+	   core.log (w)
+	  Subroutines:
+	   writeRecord
+	************************************************/
+	
 	/* Declare local variables */
-	ArEventLogWrite_typ fbWrite;
-	char asciiMessage[CORE_FORMAT_SIZE + 1];
+	coreLogRecordType record, *pRecord;
 	const unsigned char severityMap[] = {
 		arEVENTLOG_SEVERITY_ERROR, /* CORE_LOG_SEVERITY_ERROR */
 		arEVENTLOG_SEVERITY_WARNING, /* CORE_LOG_SEVERITY_WARNING */
@@ -93,7 +106,6 @@ long coreLog(ArEventLogIdentType ident, coreLogSeverityEnum severity, unsigned c
 		arEVENTLOG_SEVERITY_SUCCESS, /* CORE_LOG_SEVERITY_SUCCESS */
 		arEVENTLOG_SEVERITY_INFO, /* CORE_LOG_SEVERITY_DEBUG */
 	};
-	long status;
 	
 	/* Gaurd null pointers */
 	if(ident == 0 || message == NULL)
@@ -103,30 +115,78 @@ long coreLog(ArEventLogIdentType ident, coreLogSeverityEnum severity, unsigned c
 	if(!core.debug && severity >= CORE_LOG_SEVERITY_DEBUG)
 		return -1;
 	
-	/* Write message */
-	memset(&fbWrite, 0, sizeof(fbWrite));
-	fbWrite.Ident = ident;
-	fbWrite.EventID = ArEventLogMakeEventID(severityMap[severity], facility, code);
-	if(args == NULL)
-		coreStringCopy(asciiMessage, message, sizeof(asciiMessage));
+	/* Defer writes from StCoreCyclic to StCoreLogFlush once it is called */
+	if(core.log.cyclic && core.log.enabled) {
+		if(core.log.write - core.log.read >= CORE_LOG_RECORD_COUNT) {
+			core.log.dropped++;
+			return -1;
+		}
+		pRecord = &core.log.record[core.log.write % CORE_LOG_RECORD_COUNT];
+	}
 	else
-		coreFormat(asciiMessage, sizeof(asciiMessage), message, args);
-	fbWrite.AddDataFormat = arEVENTLOG_ADDFORMAT_TEXT;
-	fbWrite.AddDataSize = strlen(asciiMessage) + 1;
-	fbWrite.AddData = (unsigned long)asciiMessage;
-	coreStringCopy(fbWrite.ObjectID, object, sizeof(fbWrite.ObjectID));
-	fbWrite.Execute = true;
-	ArEventLogWrite(&fbWrite);
+		pRecord = &record;
 	
-	status = fbWrite.StatusID;
+	/* Format record */
+	pRecord->ident = ident;
+	pRecord->eventID = ArEventLogMakeEventID(severityMap[severity], facility, code);
+	if(args == NULL)
+		coreStringCopy(pRecord->message, message, sizeof(pRecord->message));
+	else
+		coreFormat(pRecord->message, sizeof(pRecord->message), message, args);
+	coreStringCopy(pRecord->object, object, sizeof(pRecord->object));
 	
-	fbWrite.Execute = false;
-	ArEventLogWrite(&fbWrite);
+	if(pRecord != &record) {
+		/* Complete the record before it is visible to StCoreLogFlush */
+		__sync_synchronize();
+		core.log.write++;
+		return 0;
+	}
 	
-	return status;
+	return writeRecord(pRecord);
 
 } /* End function */
 
+/* Write log records deferred by StCoreCyclic */
+long StCoreLogFlush(void) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.ident
+	   core.log (w)
+	  Subroutines:
+	   writeRecord
+	************************************************/
+	
+	/* Declare local variables */
+	coreFormatArgumentType args;
+	unsigned long write, dropped;
+	long count;
+	
+	/* StCoreCyclic defers records after the first call */
+	core.log.enabled = true;
+	
+	/* Write all records available at the time of the call */
+	write = core.log.write;
+	__sync_synchronize();
+	for(count = 0; core.log.read != write; count++) {
+		writeRecord(&core.log.record[core.log.read % CORE_LOG_RECORD_COUNT]);
+		__sync_synchronize(); /* Complete the write before the record is reused */
+		core.log.read++;
+	}
+	
+	/* Report records dropped since the previous call */
+	dropped = core.log.dropped;
+	if(dropped != core.log.reported) {
+		args.i[0] = (long)(dropped - core.log.reported);
+		core.log.reported = dropped;
+		coreLog(core.ident, CORE_LOG_SEVERITY_WARNING, CORE_LOGBOOK_FACILITY, coreLogCode(stCORE_WARNING_LOG), "Log", "%i records from StCoreCyclic dropped", &args);
+	}
+	
+	return count;
+	
+} /* End function */
+
 /* Read 16 bit code from 32 bit event */
 unsigned short coreLogCode(long event) {
 	return (unsigned short)event;
@@ -198,6 +258,7 @@ void coreLogServiceChannel(unsigned short result, unsigned short parameter, char
 	
 } /* End function */
 
+/* Read fault code and detail of an instance and log the message */
 void logSuperTrakFault(unsigned char section, unsigned char instance) {
 	
 	/***********************
@@ -282,52 +343,160 @@ void logSuperTrakFault(unsigned char section, unsigned char instance) {
 	
 }
 
-/* Monitor SuperTrak system and section faults and warnings */
-void coreMonitorSuperTrakFault(void) {
+/* Read fault instances of a context and log new faults and warnings, returns the service channel status */
+long readFaultInstances(unsigned char context, unsigned short *pInstanceLog) {
 	
 	/***********************
 	 Declare Local Variables
 	***********************/
-	static unsigned short systemInstance[CORE_FAULT_INSTANCE_MAX];
-	static unsigned short sectionInstance[CORE_SECTION_MAX][CORE_FAULT_INSTANCE_MAX];
 	unsigned short instance[CORE_FAULT_INSTANCE_MAX];
-	long i, j, status;
+	unsigned char section;
+	long i, status;
+	
+	/* Context 0 is the system, otherwise access the section's user address */
+	section = context == 0 ? 0 : core.sectionAddress[context - 1];
+	
+	/* Read the fault instances */
+	status = SuperTrakServChanRead(section, (unsigned short)(section == 0) * 1465 + (unsigned short)(section > 0) * 1485, 0, CORE_FAULT_INSTANCE_MAX, (unsigned long)&instance, sizeof(instance));
+	if(status) return status;
 	
-	/******
-	 System
-	******/
-	status = SuperTrakServChanRead(0, 1465, 0, CORE_FAULT_INSTANCE_MAX, (unsigned long)&instance, sizeof(instance));
-	if(status) return;
 	for(i = 0; i < CORE_FAULT_INSTANCE_MAX; i++) {
 		/* Skip if 65535 (unused) */
 		if(instance[i] == USHRT_MAX) continue;
 		
 		/* Log when a new instance is recorded */
-		if(instance[i] != systemInstance[i])
-			logSuperTrakFault(0, i);
+		if(instance[i] != pInstanceLog[i])
+			logSuperTrakFault(section, i);
+	}
+	memcpy(pInstanceLog, instance, sizeof(instance));
+	
+	return 0;
+	
+} /* End function */
+
+/* Monitor SuperTrak system and section faults and warnings */
+void coreMonitorSuperTrakFault(void) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.pCyclicStatus
+	   core.interface
+	   core.sectionAddress
+	   core.options
+	   core.ready
+	   core.diagnostics (w)
+	  Subroutines:
+	   readFaultInstances
+	   coreBitmapFind
+	************************************************/
+	
+	/***********************
+	 Declare Local Variables
+	***********************/
+	static unsigned short instanceLog[CORE_FAULT_CONTEXT_MAX][CORE_FAULT_INSTANCE_MAX];
+	static unsigned short previousStatus[CORE_FAULT_CONTEXT_MAX];
+	static unsigned long pending[BITMAP_WORDS(CORE_FAULT_CONTEXT_MAX)], sweep[BITMAP_WORDS(CORE_FAULT_CONTEXT_MAX)];
+	static unsigned char initialized, next, sweepContext;
+	static unsigned long sweepTimer;
+	unsigned short status, *pSectionStatus;
+	unsigned long contextCount, sweepInterval, reads;
+	long context, i;
+	
+	/* Context 0 is the system and 1 to sectionCount are sections in flow order */
+	contextCount = MIN(core.interface.sectionCount, CORE_SECTION_MAX) + 1;
+	
+	/* Read all contexts after initialization */
+	if(!initialized) {
+		initialized = true;
+		for(i = 0; i < contextCount; i++)
+			SET_BITMAP(pending, i);
 	}
-	memcpy(systemInstance, instance, sizeof(systemInstance));
-	
-	/*******
-	 Section
-	*******/
-	for(j = 1; j < CORE_SECTION_ADDRESS_MAX; j++) {
-		/* Skip undefined sections */
-		if(core.sectionMap[j] == -1) continue;
+	
+	/*****************
+	 Status Word Edges
+	*****************/
+	/* Only read fault instances when warning or fault status changes */
+	if(core.pCyclicStatus && core.ready) {
+		status = *(unsigned short*)(core.pCyclicStatus + core.interface.systemStatusOffset) & (1U << stSYSTEM_WARNING | 1U << stSYSTEM_FAULT);
+		if(status != previousStatus[0]) {
+			previousStatus[0] = status;
+			SET_BITMAP(pending, 0);
+		}
 		
-		/* Read the fault instances */
-		status = SuperTrakServChanRead(j, 1485, 0, CORE_FAULT_INSTANCE_MAX, (unsigned long)&instance, sizeof(instance));
-		if(status) return;
+		pSectionStatus = (unsigned short*)(core.pCyclicStatus + core.interface.sectionStatusOffset);
+		for(i = 1; i < contextCount; i++) {
+			status = pSectionStatus[i - 1] & (1U << stSECTION_WARNING | 1U << stSECTION_FAULT);
+			if(status != previousStatus[i]) {
+				previousStatus[i] = status;
+				SET_BITMAP(pending, i);
+			}
+		}
+	}
+	
+	/****************
+	 Background Sweep
+	****************/
+	/* Additional instances of an active fault or warning do not change the status word */
+	sweepInterval = MAX(core.options.FaultMonitor.SweepPeriod * 1000U / CORE_CYCLE_TIME / contextCount, 1);
+	if(++sweepTimer >= sweepInterval) {
+		sweepTimer = 0;
+		SET_BITMAP(pending, sweepContext);
+		SET_BITMAP(sweep, sweepContext);
+		sweepContext = (sweepContext + 1) % contextCount;
+	}
+	
+	/*********************
+	 Read Pending Contexts
+	*********************/
+	/* Round-robin through pending contexts until the budget is spent */
+	for(reads = 0; reads < core.options.FaultMonitor.ReadBudget; reads++) {
+		context = coreBitmapFind(pending, contextCount, next);
+		if(context < 0) break;
 		
-		for(i = 0; i < CORE_FAULT_INSTANCE_MAX; i++) {
-			/* Skip if 65535 (unused) */
-			if(instance[i] == USHRT_MAX) continue;
-			
-			/* Log when a new instance is recorded */
-			if(instance[i] != sectionInstance[core.sectionMap[j]][i])
-				logSuperTrakFault(j, i);
+		CLEAR_BITMAP(pending, context);
+		if(GET_BITMAP(sweep, context)) {
+			CLEAR_BITMAP(sweep, context);
+			core.diagnostics.faultSweeps++;
+		}
+		else
+			core.diagnostics.faultReads++;
+		
+		next = (unsigned char)((context + 1) % contextCount);
+		
+		/* Read again next cycle if the service channel fails */
+		if(readFaultInstances((unsigned char)context, instanceLog[context])) {
+			SET_BITMAP(pending, context);
+			break;
 		}
-		memcpy(sectionInstance[core.sectionMap[j]], instance, sizeof(sectionInstance[core.sectionMap[j]]));
 	}
 	
+	/* Count contexts waiting for budget */
+	for(i = 0, core.diagnostics.faultPending = 0; i < BITMAP_WORDS(CORE_FAULT_CONTEXT_MAX); i++)
+		core.diagnostics.faultPending += (unsigned char)__builtin_popcountl(pending[i]);
+	
 } /* End function */
+
+/* Write a formatted record to the logbook */
+long writeRecord(coreLogRecordType *pRecord) {
+	/* Declare local variables */
+	ArEventLogWrite_typ fbWrite;
+	long status;
+	
+	memset(&fbWrite, 0, sizeof(fbWrite));
+	fbWrite.Ident = pRecord->ident;
+	fbWrite.EventID = pRecord->eventID;
+	fbWrite.AddDataFormat = arEVENTLOG_ADDFORMAT_TEXT;
+	fbWrite.AddDataSize = strlen(pRecord->message) + 1;
+	fbWrite.AddData = (unsigned long)pRecord->message;
+	coreStringCopy(fbWrite.ObjectID, pRecord->object, sizeof(fbWrite.ObjectID));
+	fbWrite.Execute = true;
+	ArEventLogWrite(&fbWrite);
+	
+	status = fbWrite.StatusID;
+	
+	fbWrite.Execute = false;
+	ArEventLogWrite(&fbWrite);
+	
+	return status;
+}
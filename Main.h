@@ -32,12 +32,22 @@ extern "C"
 #define CORE_FORMAT_SIZE 					125
 #define CORE_FORMAT_ARGUMENT_COUNT 			6
 #define CORE_FORMAT_ARGUMENT_SIZE 			81
+#define CORE_LOG_OBJECT_SIZE 				36 		/* ArEventLog object ID length */
+#define CORE_LOG_RECORD_COUNT 				64U 	/* Log records deferred from StCoreCyclic to StCoreLogFlush */
 #define CORE_FAULT_INSTANCE_MAX 			64 		/* Up to 64 instances of faults/warnings per context */
 #define CORE_FAULT_DETAIL_MAX 				4 		/* Four 32-bit signed detail data storage per fault instance */
 #define CORE_FAULT_MAX 						32 		/* 32 faults and 32 warnings per context */
-#define CORE_COMMAND_COUNT 					48 		/* Default value, max is 64 */
+#define CORE_COMMAND_COUNT 					48 		/* Default command channels when StCoreInit CommandCount is 0 */
 #define CORE_COMMAND_BYTE_MAX 				8 		/* 64 commands max (8 bytes max) */
-#define CORE_COMMAND_BUFFER_SIZE 			4U
+#define CORE_COMMAND_MAX 					64 		/* Command channels allowed by the protocol */
+#define CORE_COMMAND_BUFFER_SIZE 			4U 		/* Default commands queued per pallet */
+#define CORE_COMMAND_POOL_PER_PALLET 		2U 		/* Default command nodes in the shared pool per pallet */
+#define CORE_COMMAND_POOL_MAX 				4096U 	/* Command nodes allowed in the shared pool */
+#define CORE_COMMAND_AGING_TIME 			20U 	/* Default wait in ms before a configuration command is scheduled with release priority */
+#define CORE_COMMAND_AGING_MAX 				50000U 	/* Longest aging time in ms, the 16-bit wait count saturates after 52428 ms */
+#define CORE_COMMAND_BATCH_MAX 				64U 	/* Maximum commands submitted by one call to StCoreCommandBatch */
+#define CORE_COMMAND_HANDLE_SLOT_BITS 		13U 	/* Handle bits 0-12 select a pool node or CORE_COMMAND_POOL_MAX + simple release target - 1 */
+#define CORE_COMMAND_GENERATION_MAX 		0x3FFFFUL /* Handle bits 13-30 hold the generation 1-262143, so handles are positive */
 #define CORE_SECTION_MAX 					64 		/* SuperTrak is allowed up to 64 gateway communication boards */
 #define CORE_SECTION_ADDRESS_MAX 			99 		/* Users can number sections with 1-99 */
 #define CORE_SECTION_SENSOR_MAX 			16 		/* 16 sensor values are available per section (some are reserved) */
@@ -46,15 +56,35 @@ extern "C"
 #define CORE_PALLET_ID_MAX 					254 	/* Users can number pallets 1-254, 0 for unidentified */
 #define CORE_CYCLE_TIME 					800U 	/* 800 us cycle time */
 #define CORE_CONFIGURATION_TIMEOUT 			500000U /* 500 ms to save global interface parameters */
-#define CORE_COMMAND_TIMEOUT 				500000U /* 500 ms command request timeout */
+#define CORE_COMMAND_TIMEOUT 				500000U /* 500 ms default ceiling of the adaptive command timeout */
+#define CORE_COMMAND_TIMEOUT_MAX 			600000U /* Longest timeout ceiling in ms, microsecond timestamps overflow after 4294967 ms */
 #define CORE_TARGET_RELEASE_PER_BYTE 		4U
 #define CORE_TARGET_RELEASE_BIT_COUNT 		2U
 #define CORE_COMMAND_DATA_BYTE_COUNT 		8U
-#define CORE_COMMAND_FLAG_PER_BYTE 			8U 		/* This is an internal count to store flags for each command channel */
 #define CORE_TARGET_STATUS_BYTE_COUNT 		3U
 #define CORE_COMMAND_STATUS_PER_BYTE 		4U
 #define CORE_COMMAND_STATUS_BIT_COUNT 		2U
 #define CORE_NETWORK_IO_PER_BYTE 			8U
+#define CORE_TIMING_BUCKET_COUNT 			8 		/* Execution time histogram buckets, see coreTimingRecord */
+#define CORE_BITMAP_WORD_BITS 				32U 	/* Bits used per unsigned long word of bit arrays */
+#define CORE_FAULT_CONTEXT_MAX 				(CORE_SECTION_MAX + 1) /* Fault monitor context 0 is the system, 1-64 are sections in flow order */
+#define CORE_FAULT_READ_BUDGET 				2U 		/* Default fault instance reads per cycle */
+#define CORE_FAULT_SWEEP_PERIOD 			1000U 	/* Default period in ms to read all fault contexts in the background */
+#define CORE_PALLET_EVENT_COUNT 			512U 	/* Pallet change events retained for StCoreGetPalletEvents */
+#define CORE_PALLET_CHANGE_HISTORY 			32U 	/* Pallet updates retained for StCoreGetChangedPallets */
+#define CORE_PALLET_CHANGE_UPDATE_MASK 		0xFFFFFFUL /* Pallet updates counted by a StCoreGetChangedPallets cursor */
+#define CORE_COMMAND_EVENT_COUNT 			1024U 	/* Command completion events retained for StCoreGetCommandEvents */
+#define CORE_COMMAND_WHEEL_SIZE 			256U 	/* Deadline wheel slots, one per cycle, longer deadlines take more laps */
+#define CORE_COMMAND_LATENCY_BUCKET_COUNT 	24 		/* Response time buckets of the adaptive timeout, see coreCommandLatency */
+#define CORE_COMMAND_LATENCY_WINDOW 		512U 	/* Responses per command before the distribution is halved */
+#define CORE_COMMAND_LATENCY_SAMPLES 		32U 	/* Responses per command before the adaptive timeout replaces the ceiling */
+#define CORE_COMMAND_TIMEOUT_FLOOR 			100U 	/* Default minimum adaptive timeout in ms */
+#define CORE_COMMAND_TIMEOUT_FACTOR 		4.0 	/* Default multiple of the 99th percentile response time */
+#define CORE_COMMAND_RETRY_MAX 				8U 		/* Retries allowed per command by the retry policy */
+#define CORE_COMMAND_GROUP_MAX 				4U 		/* Commands sent together by StCoreCommandGroup */
+#define CORE_COMMAND_GROUP_HOLD 			25U 	/* Cycles a group waits for enough free channels before other pallet buffers are paused to hold channels for it */
+#define CORE_PARAMETER_PERIOD 				1000U 	/* Default refresh period in ms of power parameters */
+#define CORE_TELEMETRY_READ_BUDGET 			4U 		/* Default section telemetry reads per cycle */
 /* These command IDs are defined by the SuperTrak PLC communication protocol */
 #define CORE_COMMAND_ID_RELEASE 			16 		/* 16, 17, 18, 19 target/pallet? left/right? */
 #define CORE_COMMAND_ID_OFFSET 				24 		/* 24, 25, 26, 27 */
@@ -75,6 +105,13 @@ extern "C"
 #define SET_BIT(x,y) ((x) |= 1U << (y))
 #define CLEAR_BIT(x,y) ((x) &= ~(1U << (y)))
 #define TOGGLE_BIT(x,y) ((x) ^= 1U << (y))
+#define BITMAP_WORDS(n) (((n) + CORE_BITMAP_WORD_BITS - 1) / CORE_BITMAP_WORD_BITS)
+#define GET_BITMAP(p,i) (((p)[(i) / CORE_BITMAP_WORD_BITS] >> ((i) % CORE_BITMAP_WORD_BITS)) & 1UL)
+#define SET_BITMAP(p,i) ((p)[(i) / CORE_BITMAP_WORD_BITS] |= 1UL << ((i) % CORE_BITMAP_WORD_BITS))
+#define CLEAR_BITMAP(p,i) ((p)[(i) / CORE_BITMAP_WORD_BITS] &= ~(1UL << ((i) % CORE_BITMAP_WORD_BITS)))
+#define SET_BITMAP_ATOMIC(p,i) __sync_fetch_and_or(&(p)[(i) / CORE_BITMAP_WORD_BITS], 1UL << ((i) % CORE_BITMAP_WORD_BITS))
+#define CLEAR_BITMAP_ATOMIC(p,i) __sync_fetch_and_and(&(p)[(i) / CORE_BITMAP_WORD_BITS], ~(1UL << ((i) % CORE_BITMAP_WORD_BITS)))
+#define COUNT_TRAILING_ZEROS(x) ((unsigned long)__builtin_ctzl(x)) /* Undefined for x = 0 */
 
 /************
  Enumerations
@@ -91,6 +128,9 @@ typedef enum coreCommandStatusEnum { /* Command states for status byte, do not e
 	CORE_COMMAND_PENDING = 0, /* The command request is pending */
 	CORE_COMMAND_BUSY, /* The command request is executing */
 	CORE_COMMAND_DONE, /* The command request has been acknowledged */
+	CORE_COMMAND_RESERVED, /* The command is being written by a request and not yet pending */
+	CORE_COMMAND_SUPERSEDED, /* The command was replaced by a newer request before it was sent */
+	CORE_COMMAND_CANCELLED, /* The command was cancelled by the requester before it was sent */
 	CORE_COMMAND_ERROR = 7 /* The command request has acknowledged with error */
 } coreCommandStatusEnum;
 
@@ -100,6 +140,38 @@ typedef enum coreFunctionStateEnum {
 	CORE_FUNCTION_ERROR = 255 /* The function block is enabled but in error */
 } coreFunctionStateEnum;
 
+typedef enum coreCyclicPhaseEnum { /* Execution phases of StCoreCyclic for timing diagnostics */
+	CORE_PHASE_COMMAND = 0, /* coreCommandManager */
+	CORE_PHASE_CONTROL, /* SuperTrakProcessControl */
+	CORE_PHASE_CYCLIC, /* SuperTrakCyclic1 */
+	CORE_PHASE_STATUS, /* SuperTrakProcessStatus */
+	CORE_PHASE_FAULT, /* coreMonitorSuperTrakFault */
+	CORE_PHASE_TELEMETRY, /* coreSectionTelemetry */
+	CORE_PHASE_PALLET, /* Pallet manager */
+	CORE_PHASE_TOTAL, /* StCoreCyclic */
+	CORE_PHASE_COUNT
+} coreCyclicPhaseEnum;
+
+typedef enum coreParameterGroupEnum { /* Service channel parameters refreshed together */
+	CORE_PARAMETER_PALLET = 0, /* Pallet velocity and setpoints */
+	CORE_PARAMETER_DESTINATION, /* Pallet destination shared by pallet and target status */
+	CORE_PARAMETER_TARGET, /* Target section and position */
+	CORE_PARAMETER_FAULT, /* Active system faults and warnings */
+	CORE_PARAMETER_POWER, /* System load, peak, and average power */
+	CORE_PARAMETER_GROUP_COUNT
+} coreParameterGroupEnum;
+
+typedef enum coreTelemetryStepEnum { /* Section telemetry reads in order */
+	CORE_TELEMETRY_WARNINGS = 0,
+	CORE_TELEMETRY_FAULTS,
+	CORE_TELEMETRY_PALLET_COUNT,
+	CORE_TELEMETRY_LOAD_POWER,
+	CORE_TELEMETRY_PEAK_POWER,
+	CORE_TELEMETRY_AVERAGE_POWER,
+	CORE_TELEMETRY_SENSORS,
+	CORE_TELEMETRY_STEP_COUNT
+} coreTelemetryStepEnum;
+
 typedef enum coreCommandSelectEnum { /* List of commands, do not exceed 0-15 */
 	CORE_COMMAND_SIMPLE = 0,
 	CORE_COMMAND_RELEASE,
@@ -109,7 +181,8 @@ typedef enum coreCommandSelectEnum { /* List of commands, do not exceed 0-15 */
 	CORE_COMMAND_ID,
 	CORE_COMMAND_MOTION,
 	CORE_COMMAND_MECHANICAL,
-	CORE_COMMAND_CONTROL
+	CORE_COMMAND_CONTROL,
+	CORE_COMMAND_SELECT_COUNT
 } coreCommandSelectEnum;
 
 /**********
@@ -123,6 +196,24 @@ typedef struct coreFormatArgumentType {
 	char s[CORE_FORMAT_ARGUMENT_COUNT][CORE_FORMAT_ARGUMENT_SIZE]; /* Strings */
 } coreFormatArgumentType;
 
+/* Logging */
+typedef struct coreLogRecordType {
+	ArEventLogIdentType ident;
+	long eventID;
+	char object[CORE_LOG_OBJECT_SIZE + 1];
+	char message[CORE_FORMAT_SIZE + 1]; /* Formatted message */
+} coreLogRecordType;
+
+typedef struct coreLogRingType {
+	volatile unsigned long write; /* Sequence of the next record, incremented by StCoreCyclic */
+	volatile unsigned long read; /* Sequence of the next record to write, incremented by StCoreLogFlush */
+	volatile unsigned long dropped; /* Records dropped because the ring is full */
+	unsigned long reported; /* Dropped records reported by StCoreLogFlush */
+	unsigned char enabled; /* StCoreLogFlush has been called */
+	unsigned char cyclic; /* StCoreCyclic is executing */
+	coreLogRecordType record[CORE_LOG_RECORD_COUNT]; /* Record at sequence % CORE_LOG_RECORD_COUNT */
+} coreLogRingType;
+
 /* Command management */
 typedef struct coreCommandCreateType {
 	unsigned char commandID; /* See TrakMaster help's PLC control interface for available IDs */
@@ -132,35 +223,204 @@ typedef struct coreCommandCreateType {
 
 typedef struct coreCommandType {
 	SuperTrakCommand_t command; /* SuperTrak command data */
-	unsigned char status; /* Command progess status */
+	volatile unsigned char status; /* Command progess status */
 	void *pInstance; /* Record instance if called from function block */
+	unsigned short next; /* Pool node + 1 of the next command for the same pallet, 0 for none */
+	unsigned long requested; /* Timestamp in microseconds when the request was published */
+	unsigned long assigned; /* Timestamp in microseconds when the command was written to the control interface */
+	volatile unsigned long generation; /* Use count of this command, part of the handle given to the requester */
+	unsigned char attempt; /* Retries so far, reset when the request is published */
+	unsigned long retry; /* Cycle count when a retried command may be sent again */
+	volatile unsigned long claim; /* Handle while pending, taken by whichever of the command manager, cancel, or replace is first */
+	unsigned char index; /* Pallet command buffer 1-255 of a pooled command */
+	unsigned char group; /* Members of the group led by this command, 0 for a single command or a member */
+	unsigned char channel; /* Channel of a busy group member, CORE_COMMAND_MAX once done */
+	long result; /* First failure of the group led by this command */
 } coreCommandType;
 
 typedef struct coreCommandBufferType {
-	unsigned char read; /* Index to execute user requests */
-	unsigned char write; /* Index to submit user requests */
+	volatile unsigned long inbox; /* Pool node + 1 of the newest request, pushed by coreCommandRequest and taken whole by coreCommandManager */
+	volatile unsigned long count; /* Commands requested and not yet done, limited by core.commandPool.palletCap */
+	unsigned short head; /* Pool node + 1 of the oldest queued command, only written by coreCommandManager */
+	unsigned short tail; /* Pool node + 1 of the newest queued command */
+	unsigned short waiting; /* Cycles the pending head command has waited for a channel */
 	unsigned char channel; /* Cyclic command channel index */
-	coreCommandType buffer[CORE_COMMAND_BUFFER_SIZE]; /* Command buffer */
 } coreCommandBufferType;
 
+typedef struct coreCommandCellType {
+	volatile unsigned long sequence; /* Cell is open for position p when equal to p and holds a node when equal to p + 1 */
+	unsigned long node; /* Free pool node */
+} coreCommandCellType;
+
+typedef struct coreCommandPoolType {
+	coreCommandType *pNode; /* Command nodes shared by all pallets */
+	coreCommandCellType *pCell; /* Queue of free nodes */
+	unsigned long size; /* Allocated nodes */
+	unsigned long mask; /* Cell count - 1, the cell count is a power of two */
+	unsigned long palletCap; /* Commands allowed per pallet */
+	volatile unsigned long enqueue; /* Position of the next free node to return */
+	volatile unsigned long dequeue; /* Position of the next free node to take */
+	volatile unsigned long used; /* Nodes taken from the pool */
+	volatile unsigned long highWater; /* Most nodes taken at once */
+	volatile unsigned long rejected; /* Requests rejected because the pool was empty */
+} coreCommandPoolType;
+
+typedef struct coreCommandChannelType {
+	unsigned long free[BITMAP_WORDS(CORE_COMMAND_MAX)]; /* Channels available to assign a command */
+	unsigned char next; /* Search for a free channel from here */
+} coreCommandChannelType;
+
+/* Pallet events */
+typedef struct corePalletEventRingType {
+	volatile unsigned long write; /* Sequence of the next event, incremented after the event is written */
+	StCorePalletEventType event[CORE_PALLET_EVENT_COUNT]; /* Event at sequence % CORE_PALLET_EVENT_COUNT */
+} corePalletEventRingType;
+
+typedef struct corePalletChangeType {
+	volatile unsigned long update; /* Number of pallet updates, incremented after the changes are written */
+	unsigned long changed[CORE_PALLET_CHANGE_HISTORY][BITMAP_WORDS(CORE_PALLET_ID_MAX + 1)]; /* Changed pallet IDs of update % CORE_PALLET_CHANGE_HISTORY */
+} corePalletChangeType;
+
+/* Command events */
+typedef struct coreCommandEventRingType {
+	volatile unsigned long write; /* Sequence of the next event, incremented after the event is written */
+	StCoreCommandEventType event[CORE_COMMAND_EVENT_COUNT]; /* Event at sequence % CORE_COMMAND_EVENT_COUNT */
+} coreCommandEventRingType;
+
+/* Command timeouts */
+typedef struct coreCommandEstimateType {
+	unsigned short histogram[CORE_COMMAND_LATENCY_BUCKET_COUNT]; /* Responses per bucket, halved every CORE_COMMAND_LATENCY_WINDOW */
+	unsigned short count; /* Responses in the histogram */
+	unsigned long timeout; /* Adaptive timeout in cycles, 0 until CORE_COMMAND_LATENCY_SAMPLES responses */
+} coreCommandEstimateType;
+
+typedef struct coreCommandTimeoutType {
+	unsigned long wheelChannels[CORE_COMMAND_WHEEL_SIZE][BITMAP_WORDS(CORE_COMMAND_MAX)]; /* Channels with a deadline at cycle % CORE_COMMAND_WHEEL_SIZE */
+	unsigned long wheelTargets[CORE_COMMAND_WHEEL_SIZE][BITMAP_WORDS(CORE_TARGET_MAX)]; /* Simple releases with a deadline at cycle % CORE_COMMAND_WHEEL_SIZE */
+	unsigned long channel[CORE_COMMAND_MAX]; /* Cycle count deadline per channel */
+	unsigned long target[CORE_TARGET_MAX]; /* Cycle count deadline per simple release, target 1 is index 0 */
+	coreCommandEstimateType estimate[CORE_COMMAND_SELECT_COUNT]; /* Response time distribution per command, see coreCommandSelectEnum */
+} coreCommandTimeoutType;
+
+/* Parameter cache */
+typedef struct coreParameterCacheType {
+	unsigned long timestamp[CORE_PARAMETER_GROUP_COUNT]; /* AsIOTimeCyclicStart of the last refresh */
+	unsigned char refreshed[CORE_PARAMETER_GROUP_COUNT]; /* The group has been read since StCoreInit */
+	short palletVelocity[CORE_PALLET_MAX]; /* Par 1314 */
+	unsigned short palletDestination[CORE_PALLET_MAX]; /* Par 1339 */
+	unsigned short palletSetSection[CORE_PALLET_MAX]; /* Par 1306 */
+	long palletSetPosition[CORE_PALLET_MAX]; /* Par 1311 */
+	float palletSetVelocity[CORE_PALLET_MAX]; /* Par 1313 */
+	float palletSetAcceleration[CORE_PALLET_MAX]; /* Par 1312 */
+	unsigned short targetSection[CORE_TARGET_MAX];
+	long targetPosition[CORE_TARGET_MAX];
+	unsigned long warnings;
+	unsigned long faults;
+	unsigned long loadPower;
+	unsigned long peakPower;
+	unsigned long averagePower;
+} coreParameterCacheType;
+
+/* Section telemetry */
+typedef struct coreTelemetryEntryType {
+	unsigned long warnings;
+	unsigned long faults;
+	unsigned short palletCount;
+	unsigned long loadPower;
+	unsigned long peakPower;
+	unsigned long averagePower;
+	unsigned short sensors[CORE_SECTION_SENSOR_MAX];
+	unsigned long cycle; /* core.cycleCount when all reads of the entry completed */
+	unsigned char valid; /* All reads have completed at least once */
+} coreTelemetryEntryType;
+
+typedef struct coreTelemetryType {
+	unsigned char section; /* Section offset being read */
+	unsigned char step; /* Next read of the section */
+	coreTelemetryEntryType entry[CORE_SECTION_MAX]; /* Indexed by section offset, see core.sectionMap */
+} coreTelemetryType;
+
+/* Status snapshot */
+typedef struct coreSnapshotType {
+	volatile unsigned long sequence; /* Odd while StCoreCyclic writes the snapshot */
+	unsigned long cycle; /* core.cycleCount of the snapshot */
+	unsigned long timestamp; /* AsIOTimeStamp when the snapshot was published */
+	unsigned char *pCyclicStatus; /* Copy of core.pCyclicStatus */
+	SuperTrakPalletInfo_t *pPalletData; /* Copy of core.pPalletData */
+	signed short palletMap[UCHAR_MAX + 1]; /* Copy of core.palletMap */
+} coreSnapshotType;
+
+/* Diagnostics */
+typedef struct coreTimingType {
+	unsigned long last; /* Most recent execution time in microseconds */
+	unsigned long min;
+	unsigned long max;
+	unsigned long count; /* Number of recorded executions */
+	double total; /* Sum of execution times for the mean */
+	unsigned long histogram[CORE_TIMING_BUCKET_COUNT]; /* Execution count per bucket */
+} coreTimingType;
+
+typedef struct coreDiagnosticsType {
+	coreTimingType phase[CORE_PHASE_COUNT]; /* Execution time per StCoreCyclic phase */
+	unsigned long overruns; /* StCoreCyclic execution exceeded the cycle time */
+	unsigned long faultReads; /* Fault instance reads requested by status changes */
+	unsigned long faultSweeps; /* Fault instance reads from the background sweep */
+	unsigned char faultPending; /* Fault contexts waiting for read budget */
+	unsigned char reset; /* Request from StCoreDiagnostics, cleared by StCoreCyclic */
+} coreDiagnosticsType;
+
+typedef struct coreCommandLatencyType {
+	coreTimingType queue; /* Time from request to channel assignment */
+	coreTimingType execution; /* Time from channel assignment to acknowledgement or error */
+	unsigned long timeouts; /* Commands without response within the adaptive timeout */
+	unsigned long errors; /* Commands SuperTrak responded to with error */
+	unsigned long retries; /* Failures and timeouts returned to pending by the retry policy */
+	unsigned long recovered; /* Commands acknowledged after at least one retry */
+	unsigned long cancelled; /* Commands cancelled by the requester before they were sent */
+} coreCommandLatencyType;
+
+typedef struct coreCommandStatisticsType {
+	coreCommandLatencyType command[CORE_COMMAND_SELECT_COUNT]; /* Latency per command, see coreCommandSelectEnum */
+	unsigned char reset; /* Request from StCoreCommandStatistics, cleared by StCoreCyclic */
+} coreCommandStatisticsType;
+
 /* Global private structure */
 struct coreGlobalType {
 	unsigned char *pCyclicControl;
 	unsigned char *pCyclicStatus;
 	coreCommandType *pSimpleRelease;
 	coreCommandBufferType *pCommandBuffer;
+	coreCommandPoolType commandPool; /* Command nodes linked per pallet buffer */
+	volatile unsigned long commandPallets[BITMAP_WORDS(CORE_PALLET_MAX)]; /* Pallet command buffers with commands reserved, pending, or busy */
+	volatile unsigned long commandTargets[BITMAP_WORDS(CORE_TARGET_MAX)]; /* Simple target releases pending or busy, target 1 is bit 0 */
+	coreCommandChannelType channels; /* Command channel allocation of coreCommandManager */
 	SuperTrakControlIfConfig_t interface;
 	signed char sectionMap[UCHAR_MAX + 1]; /* Map user address 1-99 to offset 0-63, -1 for unused */
+	unsigned char sectionAddress[CORE_SECTION_MAX]; /* Map offset 0-63 to user address 1-99 */
 	signed short palletMap[UCHAR_MAX + 1]; /* Map pallet ID 1-254 to memory structure 0-255, -1 for unused */
 	SuperTrakPalletInfo_t *pPalletData;
+	SuperTrakPalletInfo_t palletPrevious[CORE_PALLET_MAX]; /* Pallet information from the previous update */
+	corePalletEventRingType palletEvents;
+	corePalletChangeType palletChanges;
 	unsigned char targetCount;
 	unsigned char palletCount;
 	unsigned char networkIOCount;
+	unsigned char commandCount; /* Command channels assigned by coreCommandManager */
 	unsigned char ready; 
 	unsigned char error;
 	long statusID;
 	ArEventLogIdentType ident;
 	unsigned char debug;
+	coreLogRingType log; /* Records deferred from StCoreCyclic */
+	StCoreOptionsType options; /* Options from StCoreInit with defaults applied */
+	coreParameterCacheType parameters; /* Service channel parameters shared by all status functions */
+	coreTelemetryType telemetry; /* Section parameters read by StCoreCyclic */
+	coreSnapshotType snapshot; /* Status published at the end of StCoreCyclic */
+	unsigned long cycleCount; /* Number of StCoreCyclic calls */
+	coreDiagnosticsType diagnostics;
+	coreCommandStatisticsType commandStatistics; /* Written by coreCommandManager only */
+	coreCommandEventRingType commandEvents; /* Completion of every command, written by coreCommandManager only */
+	coreCommandTimeoutType commandTimeouts; /* Deadlines and adaptive timeouts, written by coreCommandManager only */
 };
 
 /****************
@@ -180,21 +440,83 @@ void coreLogServiceChannel(unsigned short result, unsigned short parameter, char
 void coreMonitorSuperTrakFault(void);
 
 /* Commands */
-long coreSimpleRelease(unsigned char target, unsigned char localMove, void *pInstance, coreCommandType **ppCommand);
-long coreReleasePallet(unsigned char target, unsigned char pallet, unsigned short direction, unsigned char destinationTarget, void *pInstance, coreCommandType **ppCommand);
-long coreReleaseTargetOffset(unsigned char target, unsigned char pallet, unsigned short direction, unsigned char destinationTarget, double targetOffset, void *pInstance, coreCommandType **ppCommand);
-long coreReleaseIncrementalOffset(unsigned char target, unsigned char pallet, double incrementalOffset, void *pInstance, coreCommandType **ppCommand);
-long coreContinueMove(unsigned char target, unsigned char pallet, void *pInstance, coreCommandType **ppCommand);
-long coreSetPalletID(unsigned char target, unsigned char palletID, void *pInstance, coreCommandType **ppCommand);
-long coreSetMotionParameters(unsigned char target, unsigned char pallet, double velocity, double acceleration, void *pInstance, coreCommandType **ppCommand);
-long coreSetMechanicalParameters(unsigned char target, unsigned char pallet, double shelfWidth, double centerOffset, void *pInstance, coreCommandType **ppCommand);
-long coreSetControlParameters(unsigned char target, unsigned char pallet, unsigned char controlGainSet, double movingFilter, double stationaryFilter, void *pInstance, coreCommandType **ppCommand);
+long coreSimpleRelease(unsigned char target, unsigned char localMove, void *pInstance, unsigned long *pHandle);
+long coreReleasePallet(unsigned char target, unsigned char pallet, unsigned short direction, unsigned char destinationTarget, void *pInstance, unsigned long *pHandle);
+long coreReleaseTargetOffset(unsigned char target, unsigned char pallet, unsigned short direction, unsigned char destinationTarget, double targetOffset, void *pInstance, unsigned long *pHandle);
+long coreReleaseIncrementalOffset(unsigned char target, unsigned char pallet, double incrementalOffset, void *pInstance, unsigned long *pHandle);
+long coreContinueMove(unsigned char target, unsigned char pallet, void *pInstance, unsigned long *pHandle);
+long coreSetPalletID(unsigned char target, unsigned char palletID, void *pInstance, unsigned long *pHandle);
+long coreSetMotionParameters(unsigned char target, unsigned char pallet, double velocity, double acceleration, void *pInstance, unsigned long *pHandle);
+long coreSetMechanicalParameters(unsigned char target, unsigned char pallet, double shelfWidth, double centerOffset, void *pInstance, unsigned long *pHandle);
+long coreSetControlParameters(unsigned char target, unsigned char pallet, unsigned char controlGainSet, double movingFilter, double stationaryFilter, void *pInstance, unsigned long *pHandle);
 
 /* Command management */
 void coreAssign16(unsigned short *pInteger, unsigned char bit, unsigned char value);
 long coreCommandCreate(unsigned char start, unsigned char target, unsigned char pallet, unsigned short direction, coreCommandCreateType *create);
-long coreCommandRequest(unsigned char index, SuperTrakCommand_t command, void *pInstance, coreCommandType **ppCommand);
+void coreCommandPack(unsigned char start, coreCommandCreateType *create, unsigned char value, double first, double second, SuperTrakCommand_t *pData);
+void coreCommandDescribe(SuperTrakCommand_t data, coreFormatArgumentType *args);
+long coreCommandRequest(unsigned char index, SuperTrakCommand_t command, void *pInstance, unsigned long *pHandle);
+long coreCommandReserve(unsigned char index, coreCommandType **ppCommand, unsigned long *pCount);
+void coreCommandUnreserve(unsigned char index, coreCommandType *pCommand);
+void coreCommandPublish(unsigned char index, coreCommandType *pCommand, SuperTrakCommand_t *pData, void *pInstance);
+long coreCommandBuild(StCoreCommandType *pEntry, unsigned char *pIndex, SuperTrakCommand_t *pData);
 void coreCommandManager(void);
+coreCommandType* coreCommandAllocate(void);
+void coreCommandFree(coreCommandType *pCommand);
+
+/* Pallets */
+unsigned short corePalletUpdate(void);
+
+/* Parameter cache */
+void coreParameterRefresh(coreParameterGroupEnum group);
+void coreSectionTelemetry(void);
+
+/* Status snapshot */
+void coreSnapshotPublish(void);
+unsigned long coreSnapshotBegin(void);
+unsigned char coreSnapshotRetry(unsigned long sequence);
+
+/* Diagnostics */
+unsigned long coreTimingStart(void);
+unsigned long coreTimingRecord(coreCyclicPhaseEnum phase, unsigned long start);
+void coreTimingAdd(coreTimingType *pTiming, unsigned long elapsed, const unsigned long *pLimit);
+
+/* Command statistics */
+coreCommandSelectEnum coreCommandSelect(unsigned char commandID);
+void coreCommandAssigned(coreCommandType *pCommand, coreCommandSelectEnum select);
+void coreCommandFinished(coreCommandType *pCommand, coreCommandSelectEnum select, long result);
+
+/* Command handles */
+void coreCommandGeneration(coreCommandType *pCommand);
+unsigned long coreCommandHandle(coreCommandType *pCommand);
+unsigned char coreCommandStatus(unsigned long handle, unsigned char *pStatus);
+coreCommandType* coreCommandSlot(unsigned long handle);
+
+/* Command events */
+void coreCommandEvent(coreCommandType *pCommand, coreCommandSelectEnum select, long result, unsigned long latency);
+
+/* Command timeouts */
+void coreCommandLatency(coreCommandSelectEnum select, unsigned long elapsed);
+unsigned long coreCommandTimeout(coreCommandSelectEnum select);
+void coreDeadlineStartChannel(unsigned char channel, coreCommandSelectEnum select);
+void coreDeadlineCancelChannel(unsigned char channel);
+void coreDeadlineStartTarget(unsigned char index);
+void coreDeadlineCancelTarget(unsigned char index);
+void coreDeadlineExpired(unsigned long *pChannels, unsigned long *pTargets);
+
+/* Command retries */
+unsigned char coreCommandRetry(coreCommandType *pCommand, coreCommandSelectEnum select, long result);
+unsigned char coreCommandReady(coreCommandType *pCommand);
+
+/* Command cancel and replace */
+unsigned char coreCommandTake(coreCommandType *pCommand);
+
+/* Command groups */
+long coreGroupAssign(coreCommandBufferType *pBuffer, coreCommandType *pLeader);
+unsigned char coreGroupMonitor(coreCommandType *pLeader, unsigned long *pExpired, unsigned long *pReleased);
+
+/* Bit arrays */
+long coreBitmapFind(unsigned long *pBitmap, unsigned long count, unsigned long start);
 
 /* Miscellaneous */
 void coreAssignUInt16(unsigned short *pInt, unsigned char bit, unsigned char value);
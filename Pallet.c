@@ -11,10 +11,11 @@
 static long logMessage(coreLogSeverityEnum severity, unsigned short code, char *message, coreFormatArgumentType *args);
 static void resetOutput(StCorePallet_typ *inst);
 static void activateCommand(StCorePallet_typ *inst, unsigned char select);
-static void resetCommand(StCorePallet_typ *inst);
+static void resetCommand(StCorePallet_typ *inst, unsigned char select);
 static void recordInput(StCorePallet_typ *inst, unsigned short *pData);
 static void controlError(StCorePallet_typ *inst, long status);
 static void statusError(StCorePallet_typ *inst, long status);
+static void publishEvent(unsigned char event, unsigned char index, unsigned char palletID, unsigned char previousPalletID);
 
 /* Get pallet status */
 long StCorePalletStatus(unsigned char Pallet, StCorePalletStatusType *Status) {
@@ -25,24 +26,26 @@ long StCorePalletStatus(unsigned char Pallet, StCorePalletStatusType *Status) {
 	   core.palletCount
 	   core.palletMap
 	   core.pPalletData
+	   core.parameters
+	   core.snapshot
+	   core.options
 	   core.error
 	   core.statusID
 	  Subroutines:
 	   resetOutput
 	   logMessage
+	   coreParameterRefresh
+	   coreSnapshotBegin
+	   coreSnapshotRetry
 	************************************************/
 	
 	/*********************** 
 	 Declare Local Variables
 	***********************/
-	SuperTrakPalletInfo_t *pPalletData;
-	static long timestamp;
-	static short velocity[CORE_PALLET_MAX];
-	static unsigned short destination[CORE_PALLET_MAX];
-	static unsigned short setSection[CORE_PALLET_MAX];
-	static long setPosition[CORE_PALLET_MAX];
-	static float setVelocity[CORE_PALLET_MAX];
-	static float setAcceleration[CORE_PALLET_MAX];
+	SuperTrakPalletInfo_t palletData;
+	coreParameterCacheType *pCache = &core.parameters;
+	unsigned long sequence, cycle, timestamp;
+	short index;
 	
 	/*****
 	 Clear
@@ -57,57 +60,275 @@ long StCorePalletStatus(unsigned char Pallet, StCorePalletStatusType *Status) {
 		return core.statusID;
 	
 	/* Check reference */
-	if(core.pPalletData == NULL)
+	if(core.pPalletData == NULL || (core.options.Snapshot && core.snapshot.pPalletData == NULL))
 		return stCORE_ERROR_ALLOCATION;
-		
-	/* Check user input */
-	if(core.palletMap[Pallet] == -1)
-		return stCORE_ERROR_PALLET;
-		
+	
 	/******
 	 Status
 	******/
-	/* Access the pallet information structure */
-	pPalletData = core.pPalletData + core.palletMap[Pallet];
+	/* Copy the pallet information structure, repeat if StCoreCyclic publishes a new snapshot during the copy */
+	if(core.options.Snapshot) {
+		do {
+			sequence = coreSnapshotBegin();
+			index = core.snapshot.palletMap[Pallet];
+			if(index != -1)
+				memcpy(&palletData, core.snapshot.pPalletData + index, sizeof(palletData));
+			cycle = core.snapshot.cycle;
+			timestamp = core.snapshot.timestamp;
+		} while(coreSnapshotRetry(sequence));
+	}
+	else {
+		index = core.palletMap[Pallet];
+		if(index != -1)
+			memcpy(&palletData, core.pPalletData + index, sizeof(palletData));
+		cycle = core.cycleCount;
+		timestamp = 0;
+	}
+	
+	/* Check user input */
+	if(index == -1)
+		return stCORE_ERROR_PALLET;
+	
+	Status->Info.Cycle = cycle;
+	if(core.options.Snapshot)
+		Status->Info.Age = (unsigned long)AsIOTimeStamp() - timestamp;
 	
 	/* Copy data */
-	Status->Present = GET_BIT(pPalletData->status, stPALLET_PRESENT);
-	Status->Recovering = GET_BIT(pPalletData->status, stPALLET_RECOVERING);
-	Status->AtTarget = GET_BIT(pPalletData->status, stPALLET_AT_TARGET);
-	Status->InPosition = GET_BIT(pPalletData->status, stPALLET_IN_POSITION);
-	Status->ServoEnabled = GET_BIT(pPalletData->status, stPALLET_SERVO_ENABLED);
-	Status->Initializing = GET_BIT(pPalletData->status, stPALLET_INITIALIZING);
-	Status->Lost = GET_BIT(pPalletData->status, stPALLET_LOST);
-	
-	Status->Section = pPalletData->section;
-	Status->Position = ((double)pPalletData->position) / 1000.0;
-	Status->Info.PositionUm = pPalletData->position;
-	Status->Info.ControlMode = pPalletData->controlMode;
-	
-	/* Wait for new scan to read parameters */
-	if(timestamp != AsIOTimeCyclicStart()) {
-		timestamp = AsIOTimeCyclicStart();
-		SuperTrakServChanRead(0, 1314, 0, core.palletCount, (unsigned long)&velocity, sizeof(velocity));
-		SuperTrakServChanRead(0, 1339, 0, core.palletCount, (unsigned long)&destination, sizeof(destination));
-		SuperTrakServChanRead(0, 1306, 0, core.palletCount, (unsigned long)&setSection, sizeof(setSection));
-		SuperTrakServChanRead(0, 1311, 0, core.palletCount, (unsigned long)&setPosition, sizeof(setPosition));
-		SuperTrakServChanRead(0, 1313, 0, core.palletCount, (unsigned long)&setVelocity, sizeof(setVelocity));
-		SuperTrakServChanRead(0, 1312, 0, core.palletCount, (unsigned long)&setAcceleration, sizeof(setAcceleration));
-	}
+	Status->Present = GET_BIT(palletData.status, stPALLET_PRESENT);
+	Status->Recovering = GET_BIT(palletData.status, stPALLET_RECOVERING);
+	Status->AtTarget = GET_BIT(palletData.status, stPALLET_AT_TARGET);
+	Status->InPosition = GET_BIT(palletData.status, stPALLET_IN_POSITION);
+	Status->ServoEnabled = GET_BIT(palletData.status, stPALLET_SERVO_ENABLED);
+	Status->Initializing = GET_BIT(palletData.status, stPALLET_INITIALIZING);
+	Status->Lost = GET_BIT(palletData.status, stPALLET_LOST);
+	
+	Status->Section = palletData.section;
+	Status->Position = ((double)palletData.position) / 1000.0;
+	Status->Info.PositionUm = palletData.position;
+	Status->Info.ControlMode = palletData.controlMode;
+	
+	/* Refresh shared parameters */
+	coreParameterRefresh(CORE_PARAMETER_PALLET);
+	coreParameterRefresh(CORE_PARAMETER_DESTINATION);
 	
 	/* Copy data */
-	Status->Info.Velocity = (float)velocity[core.palletMap[Pallet]];
-	Status->Info.DestinationTarget = (unsigned char)destination[core.palletMap[Pallet]];
-	Status->Info.SetSection = (unsigned char)setSection[core.palletMap[Pallet]];
-	Status->Info.SetPosition = ((double)setPosition[core.palletMap[Pallet]]) / 1000.0;
-	Status->Info.SetPositionUm = setPosition[core.palletMap[Pallet]];
-	Status->Info.SetVelocity = setVelocity[core.palletMap[Pallet]];
-	Status->Info.SetAcceleration = setAcceleration[core.palletMap[Pallet]] * 1000.0;
+	Status->Info.Velocity = (float)pCache->palletVelocity[index];
+	Status->Info.DestinationTarget = (unsigned char)pCache->palletDestination[index];
+	Status->Info.SetSection = (unsigned char)pCache->palletSetSection[index];
+	Status->Info.SetPosition = ((double)pCache->palletSetPosition[index]) / 1000.0;
+	Status->Info.SetPositionUm = pCache->palletSetPosition[index];
+	Status->Info.SetVelocity = pCache->palletSetVelocity[index];
+	Status->Info.SetAcceleration = pCache->palletSetAcceleration[index] * 1000.0;
 	
 	return 0;
 	
 } /* End function */
 
+/* Get pallet change events */
+long StCoreGetPalletEvents(StCorePalletEventType *pEvents, unsigned char Size, unsigned long *Cursor) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.palletEvents
+	************************************************/
+	
+	/*********************** 
+	 Declare Local Variables
+	***********************/
+	unsigned long write, start, count;
+	
+	/******
+	 Verify
+	******/
+	/* Check references */
+	if(pEvents == NULL || Cursor == NULL)
+		return stCORE_ERROR_ALLOCATION;
+	
+	/* Move to the oldest event if the cursor has been overwritten */
+	write = core.palletEvents.write;
+	__sync_synchronize();
+	if(write - *Cursor > CORE_PALLET_EVENT_COUNT) {
+		*Cursor = write > CORE_PALLET_EVENT_COUNT ? write - CORE_PALLET_EVENT_COUNT : 0;
+		return stCORE_WARNING_PALLET_EVENT;
+	}
+	
+	/****
+	 Copy
+	****/
+	start = *Cursor;
+	for(count = 0; count < Size && start + count != write; count++)
+		memcpy(pEvents + count, &core.palletEvents.event[(start + count) % CORE_PALLET_EVENT_COUNT], sizeof(*pEvents));
+	
+	/* StCoreCyclic may interrupt the copy, discard if the first event copied has since been overwritten */
+	__sync_synchronize();
+	write = core.palletEvents.write;
+	if(write - start > CORE_PALLET_EVENT_COUNT) {
+		*Cursor = write - CORE_PALLET_EVENT_COUNT;
+		return stCORE_WARNING_PALLET_EVENT;
+	}
+	
+	*Cursor = start + count;
+	return (long)count;
+	
+} /* End function */
+
+/* Get IDs of pallets with changed information since the cursor */
+long StCoreGetChangedPallets(unsigned char *pPalletIDs, unsigned char Size, unsigned long *Cursor) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.palletChanges
+	************************************************/
+	
+	/*********************** 
+	 Declare Local Variables
+	***********************/
+	unsigned long changed[BITMAP_WORDS(CORE_PALLET_ID_MAX + 1)], update, base, resume, last, i, j, word, palletID, count, pass;
+	
+	/******
+	 Verify
+	******/
+	/* Check references */
+	if(pPalletIDs == NULL || Cursor == NULL)
+		return stCORE_ERROR_ALLOCATION;
+	
+	/*******
+	 Combine
+	*******/
+	/* The cursor holds the last fully read update and the last pallet ID read since */
+	base = *Cursor >> 8;
+	resume = *Cursor & 0xFF;
+	
+	/* Combine the changes of each update since the cursor */
+	memset(changed, 0, sizeof(changed));
+	update = core.palletChanges.update;
+	__sync_synchronize();
+	if(((update - base) & CORE_PALLET_CHANGE_UPDATE_MASK) <= CORE_PALLET_CHANGE_HISTORY) {
+		for(i = base + 1; ((i - 1) & CORE_PALLET_CHANGE_UPDATE_MASK) != (update & CORE_PALLET_CHANGE_UPDATE_MASK); i++) {
+			for(j = 0; j < BITMAP_WORDS(CORE_PALLET_ID_MAX + 1); j++)
+				changed[j] |= core.palletChanges.changed[i % CORE_PALLET_CHANGE_HISTORY][j];
+		}
+		__sync_synchronize();
+	}
+	
+	/* Report all pallets if the history since the cursor is incomplete or was overwritten during the copy */
+	if(((core.palletChanges.update - base) & CORE_PALLET_CHANGE_UPDATE_MASK) > CORE_PALLET_CHANGE_HISTORY) {
+		memset(changed, 0xFF, sizeof(changed));
+		base = update - CORE_PALLET_CHANGE_HISTORY - 1; /* Remain outside the history until all pallets are read */
+	}
+	
+	/****
+	 Scan
+	****/
+	/* Continue after the last pallet read and wrap around, skip unchanged pallets a word at a time */
+	last = resume;
+	for(pass = 0, count = 0; pass < 2; pass++) {
+		for(j = 0; j < BITMAP_WORDS(CORE_PALLET_ID_MAX + 1); j++) {
+			word = changed[j] & 0xFFFFFFFFUL;
+			while(word) {
+				palletID = j * CORE_BITMAP_WORD_BITS + COUNT_TRAILING_ZEROS(word);
+				word &= word - 1; /* Clear lowest set bit */
+				if(palletID < 1 || CORE_PALLET_ID_MAX < palletID)
+					continue;
+				if((palletID > resume) != (pass == 0))
+					continue;
+				
+				/* Keep the update and continue from this pallet in the next call if the array is too small */
+				if(count == Size) {
+					*Cursor = (base & CORE_PALLET_CHANGE_UPDATE_MASK) << 8 | last;
+					return (long)count;
+				}
+				pPalletIDs[count++] = (unsigned char)palletID;
+				last = palletID;
+			}
+		}
+	}
+	
+	*Cursor = (update & CORE_PALLET_CHANGE_UPDATE_MASK) << 8;
+	return (long)count;
+	
+} /* End function */
+
+/* Update pallet mapping from changes in pallet information, return the number of pallets present */
+unsigned short corePalletUpdate(void) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.pPalletData
+	   core.palletCount
+	   core.palletMap (w)
+	   core.palletPrevious (w)
+	   core.palletChanges (w)
+	  Subroutines:
+	   publishEvent
+	************************************************/
+	
+	/*********************** 
+	 Declare Local Variables
+	***********************/
+	SuperTrakPalletInfo_t *pPalletData, *pPrevious;
+	unsigned long *pChanged;
+	unsigned short i, presentCount;
+	unsigned char present, previousPresent;
+	
+	if(core.pPalletData == NULL)
+		return 0;
+	
+	/* Clear the oldest changes for this update */
+	pChanged = core.palletChanges.changed[(core.palletChanges.update + 1) % CORE_PALLET_CHANGE_HISTORY];
+	memset(pChanged, 0, sizeof(core.palletChanges.changed[0]));
+	
+	for(i = 0, presentCount = 0; i < core.palletCount; i++) {
+		pPalletData = core.pPalletData + i;
+		pPrevious = core.palletPrevious + i;
+		present = GET_BIT(pPalletData->status, stPALLET_PRESENT);
+		previousPresent = GET_BIT(pPrevious->status, stPALLET_PRESENT);
+		
+		/* Count the number of pallets present up to the user allocated amount */
+		if(present)
+			presentCount++;
+		
+		/* Most pallets are unchanged */
+		if(pPalletData->palletID == pPrevious->palletID && pPalletData->status == pPrevious->status && pPalletData->section == pPrevious->section 
+			&& pPalletData->position == pPrevious->position && pPalletData->controlMode == pPrevious->controlMode)
+			continue;
+		
+		/* Mark changed pallets by ID */
+		if(pPalletData->palletID)
+			SET_BITMAP(pChanged, pPalletData->palletID);
+		
+		/* Only remap pallet IDs that have changed so the mapping remains valid for other tasks */
+		if(pPalletData->palletID != pPrevious->palletID) {
+			if(pPrevious->palletID) {
+				SET_BITMAP(pChanged, pPrevious->palletID);
+				if(core.palletMap[pPrevious->palletID] == i)
+					core.palletMap[pPrevious->palletID] = -1;
+			}
+			if(pPalletData->palletID)
+				core.palletMap[pPalletData->palletID] = i;
+			publishEvent(stCORE_PALLET_ID_CHANGED, i, pPalletData->palletID, pPrevious->palletID);
+		}
+		
+		/* Publish presence changes */
+		if(present && !previousPresent)
+			publishEvent(stCORE_PALLET_APPEARED, i, pPalletData->palletID, pPrevious->palletID);
+		else if(!present && previousPresent)
+			publishEvent(stCORE_PALLET_DISAPPEARED, i, pPalletData->palletID, pPrevious->palletID);
+		
+		memcpy(pPrevious, pPalletData, sizeof(*pPrevious));
+	}
+	
+	/* Complete the changes before they are visible to readers */
+	__sync_synchronize();
+	core.palletChanges.update++;
+	
+	return presentCount;
+	
+} /* End function */
+
 /* Pallet interface */
 void StCorePallet(StCorePallet_typ *inst) {
 	
@@ -129,7 +350,8 @@ void StCorePallet(StCorePallet_typ *inst) {
 	long status;
 	StCorePalletStatusType palletStatus;
 	unsigned short input;
-	coreCommandType *pCommand;
+	unsigned char commandStatus, select;
+	StCoreCommandProgressType *pCommand;
 	
 	/*************
 	 State Machine
@@ -187,7 +409,7 @@ void StCorePallet(StCorePallet_typ *inst) {
 			/* Set motion parameters */
 			if(inst->SetMotionParameters && !GET_BIT(inst->Internal.PreviousCommand, CORE_COMMAND_MOTION)) {
 				/* Run and activate */
-				status = coreSetMotionParameters(0, inst->Internal.Select, inst->Parameters.Motion.Velocity, inst->Parameters.Motion.Acceleration, (void*)inst, (coreCommandType**)&inst->Internal.pCommand);
+				status = coreSetMotionParameters(0, inst->Internal.Select, inst->Parameters.Motion.Velocity, inst->Parameters.Motion.Acceleration, (void*)inst, &inst->Internal.Handle[CORE_COMMAND_MOTION]);
 				if(status) { 
 					controlError(inst, status);
 					break;
@@ -199,7 +421,7 @@ void StCorePallet(StCorePallet_typ *inst) {
 			/* Set mechanical parameters */
 			if(inst->SetMechanicalParameters && !GET_BIT(inst->Internal.PreviousCommand, CORE_COMMAND_MECHANICAL)) {
 				/* Run and activate */
-				status = coreSetMechanicalParameters(0, inst->Internal.Select, inst->Parameters.Mechanical.ShelfWidth, inst->Parameters.Mechanical.CenterOffset, (void*)inst, (coreCommandType**)&inst->Internal.pCommand);
+				status = coreSetMechanicalParameters(0, inst->Internal.Select, inst->Parameters.Mechanical.ShelfWidth, inst->Parameters.Mechanical.CenterOffset, (void*)inst, &inst->Internal.Handle[CORE_COMMAND_MECHANICAL]);
 				if(status) { 
 					controlError(inst, status);
 					break;
@@ -211,7 +433,7 @@ void StCorePallet(StCorePallet_typ *inst) {
 			/* Set mechanical parameters */
 			if(inst->SetControlParameters && !GET_BIT(inst->Internal.PreviousCommand, CORE_COMMAND_CONTROL)) {
 				/* Run and activate */
-				status = coreSetControlParameters(0, inst->Internal.Select, inst->Parameters.Control.ControlGainSet, inst->Parameters.Control.MovingFilter, inst->Parameters.Control.StationaryFilter, (void*)inst, (coreCommandType**)&inst->Internal.pCommand);
+				status = coreSetControlParameters(0, inst->Internal.Select, inst->Parameters.Control.ControlGainSet, inst->Parameters.Control.MovingFilter, inst->Parameters.Control.StationaryFilter, (void*)inst, &inst->Internal.Handle[CORE_COMMAND_CONTROL]);
 				if(status) { 
 					controlError(inst, status);
 					break;
@@ -223,7 +445,7 @@ void StCorePallet(StCorePallet_typ *inst) {
 			/* Release pallet */
 			if(inst->ReleasePallet && !GET_BIT(inst->Internal.PreviousCommand, CORE_COMMAND_RELEASE)) {
 				/* Run and activate */
-				status = coreReleasePallet(0, inst->Internal.Select, inst->Parameters.Release.Direction, inst->Parameters.Release.DestinationTarget, (void*)inst, (coreCommandType**)&inst->Internal.pCommand);
+				status = coreReleasePallet(0, inst->Internal.Select, inst->Parameters.Release.Direction, inst->Parameters.Release.DestinationTarget, (void*)inst, &inst->Internal.Handle[CORE_COMMAND_RELEASE]);
 				if(status) { 
 					controlError(inst, status);
 					break;
@@ -235,7 +457,7 @@ void StCorePallet(StCorePallet_typ *inst) {
 			/* Release target offset */
 			if(inst->ReleaseTargetOffset && !GET_BIT(inst->Internal.PreviousCommand, CORE_COMMAND_OFFSET)) {
 				/* Run and activate */
-				status = coreReleaseTargetOffset(0, inst->Internal.Select, inst->Parameters.Release.Direction, inst->Parameters.Release.DestinationTarget, inst->Parameters.Release.Offset, (void*)inst, (coreCommandType**)&inst->Internal.pCommand);
+				status = coreReleaseTargetOffset(0, inst->Internal.Select, inst->Parameters.Release.Direction, inst->Parameters.Release.DestinationTarget, inst->Parameters.Release.Offset, (void*)inst, &inst->Internal.Handle[CORE_COMMAND_OFFSET]);
 				if(status) { 
 					controlError(inst, status);
 					break;
@@ -247,7 +469,7 @@ void StCorePallet(StCorePallet_typ *inst) {
 			/* Release incremental offset */
 			if(inst->ReleaseIncrementalOffset && !GET_BIT(inst->Internal.PreviousCommand, CORE_COMMAND_INCREMENT)) {
 				/* Run and activate */
-				status = coreReleaseIncrementalOffset(0, inst->Internal.Select, inst->Parameters.Release.Offset, (void*)inst, (coreCommandType**)&inst->Internal.pCommand);
+				status = coreReleaseIncrementalOffset(0, inst->Internal.Select, inst->Parameters.Release.Offset, (void*)inst, &inst->Internal.Handle[CORE_COMMAND_INCREMENT]);
 				if(status) { 
 					controlError(inst, status);
 					break;
@@ -259,7 +481,7 @@ void StCorePallet(StCorePallet_typ *inst) {
 			/* Continue move */
 			if(inst->ContinueMove && !GET_BIT(inst->Internal.PreviousCommand, CORE_COMMAND_CONTINUE)) {
 				/* Run and activate */
-				status = coreContinueMove(0, inst->Internal.Select, (void*)inst, (coreCommandType**)&inst->Internal.pCommand);
+				status = coreContinueMove(0, inst->Internal.Select, (void*)inst, &inst->Internal.Handle[CORE_COMMAND_CONTINUE]);
 				if(status) { 
 					controlError(inst, status);
 					break;
@@ -271,63 +493,68 @@ void StCorePallet(StCorePallet_typ *inst) {
 			/* Record command inputs */
 			recordInput(inst, &input);
 			
-			/* Monitor active command */
-			if(inst->Busy || inst->Acknowledged) {
+			/* Monitor active commands, each command input is tracked with its own request */
+			for(select = CORE_COMMAND_RELEASE; select < CORE_COMMAND_SELECT_COUNT; select++) {
+				pCommand = &inst->Command[select];
+				if(!pCommand->Busy && !pCommand->Acknowledged)
+					continue;
+				
 				/* Clear if user resets input */
-				if(!GET_BIT(input, inst->Internal.CommandSelect))
-					resetCommand(inst);
+				if(!GET_BIT(input, select)) {
+					resetCommand(inst, select);
+					continue;
+				}
 				
-				/* Monitor buffered command address */
-				else if(inst->Internal.pCommand != 0) { 
-					if(!inst->Acknowledged) { /* Command request acknowledged */
-						pCommand = (coreCommandType*)inst->Internal.pCommand;
-						if(pCommand->pInstance == inst) { /* Buffered command matches this instance */
-							if(GET_BIT(pCommand->status, CORE_COMMAND_DONE)) {
-								if(GET_BIT(pCommand->status, CORE_COMMAND_ERROR)) {
-									args.i[0] = inst->Internal.Select;
-									logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_COMMAND), "StCorePallet pallet %i command error", &args);
-									resetOutput(inst);
-									inst->Error = true;
-									inst->StatusID = stCORE_ERROR_COMMAND;
-									inst->Internal.State = CORE_FUNCTION_ERROR;
-									break;
-								}
-								else {
-									/* Report acknowledged to user */
-									inst->Busy = false;
-									inst->Acknowledged = true;
-									inst->Internal.pCommand = 0; /* No further need to monitor buffered command address */
-								}
-							}
-						}
-						else { 	
-							/* Error if the instance tracking does not match */
-							args.i[0] = inst->Internal.Select;
-							logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_ACKNOWLEDGE), "StCorePallet pallet %i command cannot be acknowledged", &args);
-							resetOutput(inst);
-							inst->Error = true;
-							inst->StatusID = stCORE_ERROR_ACKNOWLEDGE;
-							inst->Internal.State = CORE_FUNCTION_ERROR;
-							break;
-							
-						} /* Instance matches buffered command? */
-					} /* Command request acknowledged? */
-					
-					/* Wait here while acknowledged for user command to reset */
-					
-				} /* Non-zero buffered command address? */
+				/* Wait here while acknowledged for user command to reset */
+				if(pCommand->Acknowledged)
+					continue;
 				
-				/* Error if buffered command address was not shared */
-				else if(!inst->Acknowledged) {
+				/* Error if the command was reused before its completion was seen */
+				if(!coreCommandStatus(inst->Internal.Handle[select], &commandStatus)) { /* Handle still refers to this instance's request */
 					args.i[0] = inst->Internal.Select;
-					logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_ACKNOWLEDGE), "StCorePallet pallet %i command cannot be acknowledged", &args);
+					args.i[1] = select;
+					logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_ACKNOWLEDGE), "StCorePallet pallet %i command %i cannot be acknowledged", &args);
 					resetOutput(inst);
 					inst->Error = true;
 					inst->StatusID = stCORE_ERROR_ACKNOWLEDGE;
 					inst->Internal.State = CORE_FUNCTION_ERROR;
 					break;
 				}
+				
+				if(!GET_BIT(commandStatus, CORE_COMMAND_DONE))
+					continue;
+				
+				if(GET_BIT(commandStatus, CORE_COMMAND_ERROR)) {
+					args.i[0] = inst->Internal.Select;
+					args.i[1] = select;
+					logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_COMMAND), "StCorePallet pallet %i command %i error", &args);
+					resetOutput(inst);
+					inst->Error = true;
+					inst->StatusID = stCORE_ERROR_COMMAND;
+					inst->Command[select].Error = true; /* Identify the failed command */
+					inst->Internal.State = CORE_FUNCTION_ERROR;
+					break;
+				}
+				
+				/* Report acknowledged to user, noting a command replaced by a newer request or cancelled before it was sent */
+				pCommand->Busy = false;
+				pCommand->Acknowledged = true;
+				pCommand->Superseded = GET_BIT(commandStatus, CORE_COMMAND_SUPERSEDED);
+				pCommand->Cancelled = GET_BIT(commandStatus, CORE_COMMAND_CANCELLED);
+				inst->Internal.Handle[select] = 0; /* No further need to monitor the command */
+			}
+			if(inst->Internal.State == CORE_FUNCTION_ERROR)
+				break;
+			
+			/* Busy while any command executes, acknowledged once every active command is acknowledged */
+			inst->Busy = false;
+			inst->Acknowledged = false;
+			for(select = CORE_COMMAND_RELEASE; select < CORE_COMMAND_SELECT_COUNT; select++) {
+				inst->Busy |= inst->Command[select].Busy;
+				inst->Acknowledged |= inst->Command[select].Acknowledged;
 			}
+			if(inst->Busy)
+				inst->Acknowledged = false;
 			
 			/******
 			 Status
@@ -401,6 +628,7 @@ void resetOutput(StCorePallet_typ *inst) {
 	memset(&inst->Info, 0, sizeof(inst->Info));
 	inst->Busy = false;
 	inst->Acknowledged = false;
+	memset(&inst->Command, 0, sizeof(inst->Command));
 	/* Do not clear internal data */
 } 
 
@@ -409,17 +637,23 @@ void activateCommand(StCorePallet_typ *inst, unsigned char select) {
 	/* Protect bit set */
 	if(select > CORE_COMMAND_CONTROL) /* This is the last command in enumeration */
 		return;
+	inst->Command[select].Busy = true;
+	inst->Command[select].Acknowledged = false;
+	inst->Command[select].Error = false;
+	inst->Command[select].Superseded = false;
+	inst->Command[select].Cancelled = false;
 	inst->Busy = true;
 	inst->Acknowledged = false;
-	inst->Internal.CommandSelect = select;
 }
 
 /* Reset command statuses and tracking */
-void resetCommand(StCorePallet_typ *inst) {
-	inst->Busy = false;
-	inst->Acknowledged = false;
-	inst->Internal.CommandSelect = false;
-	inst->Internal.pCommand = 0;
+void resetCommand(StCorePallet_typ *inst, unsigned char select) {
+	inst->Command[select].Busy = false;
+	inst->Command[select].Acknowledged = false;
+	inst->Command[select].Error = false;
+	inst->Command[select].Superseded = false;
+	inst->Command[select].Cancelled = false;
+	inst->Internal.Handle[select] = 0;
 }
 
 /* Aggregate command inputs */
@@ -458,3 +692,21 @@ void statusError(StCorePallet_typ *inst, long status) {
 	inst->StatusID = status;
 	inst->Internal.State = CORE_FUNCTION_ERROR;
 }
+
+/* Write pallet change event to the ring buffer */
+void publishEvent(unsigned char event, unsigned char index, unsigned char palletID, unsigned char previousPalletID) {
+	/* Declare local variables */
+	StCorePalletEventType *pEvent;
+	
+	pEvent = &core.palletEvents.event[core.palletEvents.write % CORE_PALLET_EVENT_COUNT];
+	pEvent->Sequence = core.palletEvents.write;
+	pEvent->Cycle = core.cycleCount;
+	pEvent->Event = event;
+	pEvent->Index = index;
+	pEvent->PalletID = palletID;
+	pEvent->PreviousPalletID = previousPalletID;
+	
+	/* Complete the event before it is visible to readers */
+	__sync_synchronize();
+	core.palletEvents.write++;
+}
@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * File: StCore\Parameter.c
+ * Author: agent
+ * Date: 2026-10-17
+*******************************************************************************/
+
+#include "Main.h"
+
+/* Prototypes */
+static unsigned long refreshPeriod(coreParameterGroupEnum group);
+
+/* Refresh a parameter group if its period has elapsed */
+void coreParameterRefresh(coreParameterGroupEnum group) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.parameters (w)
+	   core.palletCount
+	   core.targetCount
+	  Subroutines:
+	   refreshPeriod
+	************************************************/
+	
+	/* Declare local variables */
+	coreParameterCacheType *pCache = &core.parameters;
+	unsigned long now;
+	
+	/* Guard inputs */
+	if(group >= CORE_PARAMETER_GROUP_COUNT)
+		return;
+	
+	/* Read at most once per scan of the calling task and once per period */
+	now = (unsigned long)AsIOTimeCyclicStart();
+	if(pCache->refreshed[group]) {
+		if(now == pCache->timestamp[group])
+			return;
+		if(now - pCache->timestamp[group] < refreshPeriod(group))
+			return;
+	}
+	
+	switch(group) {
+		case CORE_PARAMETER_PALLET:
+			SuperTrakServChanRead(0, 1314, 0, core.palletCount, (unsigned long)&pCache->palletVelocity, sizeof(pCache->palletVelocity));
+			SuperTrakServChanRead(0, 1306, 0, core.palletCount, (unsigned long)&pCache->palletSetSection, sizeof(pCache->palletSetSection));
+			SuperTrakServChanRead(0, 1311, 0, core.palletCount, (unsigned long)&pCache->palletSetPosition, sizeof(pCache->palletSetPosition));
+			SuperTrakServChanRead(0, 1313, 0, core.palletCount, (unsigned long)&pCache->palletSetVelocity, sizeof(pCache->palletSetVelocity));
+			SuperTrakServChanRead(0, 1312, 0, core.palletCount, (unsigned long)&pCache->palletSetAcceleration, sizeof(pCache->palletSetAcceleration));
+			break;
+		
+		case CORE_PARAMETER_DESTINATION:
+			SuperTrakServChanRead(0, 1339, 0, core.palletCount, (unsigned long)&pCache->palletDestination, sizeof(pCache->palletDestination));
+			break;
+		
+		case CORE_PARAMETER_TARGET:
+			SuperTrakServChanRead(0, stPAR_TARGET_SECTION, 0, core.targetCount, (unsigned long)&pCache->targetSection, sizeof(pCache->targetSection));
+			SuperTrakServChanRead(0, stPAR_TARGET_POSITION, 0, core.targetCount, (unsigned long)&pCache->targetPosition, sizeof(pCache->targetPosition));
+			break;
+		
+		case CORE_PARAMETER_FAULT:
+			SuperTrakServChanRead(0, stPAR_SYSTEM_FAULTS_ACTIVE, 1, 1, (unsigned long)&pCache->warnings, sizeof(pCache->warnings));
+			SuperTrakServChanRead(0, stPAR_SYSTEM_FAULTS_ACTIVE, 0, 1, (unsigned long)&pCache->faults, sizeof(pCache->faults));
+			break;
+		
+		case CORE_PARAMETER_POWER:
+			SuperTrakServChanRead(0, stPAR_SYSTEM_LOAD_POWER, 0, 1, (unsigned long)&pCache->loadPower, sizeof(pCache->loadPower));
+			SuperTrakServChanRead(0, stPAR_SYSTEM_PEAK_POWER, 0, 1, (unsigned long)&pCache->peakPower, sizeof(pCache->peakPower));
+			SuperTrakServChanRead(0, stPAR_SYSTEM_AVERAGE_POWER, 0, 1, (unsigned long)&pCache->averagePower, sizeof(pCache->averagePower));
+			break;
+		
+		default:
+			break;
+	}
+	
+	pCache->timestamp[group] = now;
+	pCache->refreshed[group] = true;
+	
+} /* End function */
+
+/* Refresh period in microseconds from options, 0 for every scan */
+unsigned long refreshPeriod(coreParameterGroupEnum group) {
+	switch(group) {
+		case CORE_PARAMETER_PALLET:
+			return core.options.Parameter.Pallet * 1000;
+		case CORE_PARAMETER_DESTINATION:
+			return MIN(core.options.Parameter.Pallet, core.options.Parameter.Target) * 1000; /* As fresh as either reader requests */
+		case CORE_PARAMETER_TARGET:
+			return core.options.Parameter.Target * 1000;
+		case CORE_PARAMETER_FAULT:
+			return core.options.Parameter.Fault * 1000;
+		case CORE_PARAMETER_POWER:
+			return core.options.Parameter.Power * 1000;
+		default:
+			return 0;
+	}
+}
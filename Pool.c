@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * File: StCore\Pool.c
+ * Author: agent
+ * Date: 2026-10-17
+*******************************************************************************/
+
+#include "Main.h"
+
+/* Take a free command node from the shared pool, NULL if the pool is empty or the next free node is not yet returned */
+coreCommandType* coreCommandAllocate(void) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.commandPool (rw)
+	************************************************/
+	
+	/* Declare local variables */
+	coreCommandPoolType *pPool = &core.commandPool;
+	coreCommandCellType *pCell;
+	unsigned long position, used, highWater, node;
+	long difference;
+	
+	if(pPool->pNode == NULL || pPool->pCell == NULL)
+		return NULL;
+	
+	/* Dequeue from the free queue, requests from any task class may compete */
+	position = pPool->dequeue;
+	while(true) {
+		pCell = &pPool->pCell[position & pPool->mask];
+		difference = (long)(pCell->sequence - (position + 1));
+		
+		/* Cell holds a free node, attempt to claim it */
+		if(difference == 0) {
+			if(__sync_bool_compare_and_swap(&pPool->dequeue, position, position + 1))
+				break;
+			position = pPool->dequeue;
+		}
+		
+		/* Free queue is empty, or a task returning a node claimed the cell but was preempted before publishing it */
+		else if(difference < 0) {
+			if(pPool->enqueue == position)
+				__sync_fetch_and_add(&pPool->rejected, 1); /* Count only an empty pool, the other case is transient and a repeated request succeeds */
+			return NULL;
+		}
+		
+		/* Another request claimed the cell first */
+		else
+			position = pPool->dequeue;
+	}
+	node = pCell->node;
+	__sync_synchronize();
+	pCell->sequence = position + pPool->mask + 1; /* Open the cell for the next lap */
+	
+	/* Track the high-water mark */
+	used = __sync_add_and_fetch(&pPool->used, 1);
+	do {
+		highWater = pPool->highWater;
+		if(used <= highWater)
+			break;
+	} while(!__sync_bool_compare_and_swap(&pPool->highWater, highWater, used));
+	
+	return pPool->pNode + node;
+	
+} /* End function */
+
+/* Return a command node to the shared pool */
+void coreCommandFree(coreCommandType *pCommand) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.commandPool (rw)
+	************************************************/
+	
+	/* Declare local variables */
+	coreCommandPoolType *pPool = &core.commandPool;
+	coreCommandCellType *pCell;
+	unsigned long position;
+	long difference;
+	
+	if(pPool->pNode == NULL || pPool->pCell == NULL || pCommand == NULL)
+		return;
+	
+	/* Enqueue at the tail so a freed node rests as long as possible before reuse */
+	position = pPool->enqueue;
+	while(true) {
+		pCell = &pPool->pCell[position & pPool->mask];
+		difference = (long)(pCell->sequence - position);
+		
+		/* Cell is open, attempt to claim it */
+		if(difference == 0) {
+			if(__sync_bool_compare_and_swap(&pPool->enqueue, position, position + 1))
+				break;
+			position = pPool->enqueue;
+		}
+		
+		/* The queue holds every node already, this node is not from the pool */
+		else if(difference < 0)
+			return;
+		
+		/* Another caller claimed the cell first */
+		else
+			position = pPool->enqueue;
+	}
+	pCell->node = (unsigned long)(pCommand - pPool->pNode);
+	__sync_synchronize();
+	pCell->sequence = position + 1; /* Publish the free node */
+	
+	__sync_fetch_and_sub(&pPool->used, 1);
+	
+} /* End function */
@@ -12,16 +12,20 @@ static long logMessage(coreLogSeverityEnum severity, unsigned short code, char *
 
 /* Release with local move configuration */
 long StCoreSimpleRelease(unsigned char Target, unsigned char LocalMove) {
-	return coreSimpleRelease(Target, LocalMove, NULL, NULL);
+	unsigned long handle;
+	long status;
+	status = coreSimpleRelease(Target, LocalMove, NULL, &handle);
+	return status ? status : (long)handle; /* Command handle on success */
 }
 
 /* (Internal) Release with local move configuration */
-long coreSimpleRelease(unsigned char target, unsigned char localMove, void *pInstance, coreCommandType **ppCommand) {
+long coreSimpleRelease(unsigned char target, unsigned char localMove, void *pInstance, unsigned long *pHandle) {
 	
 	/************************************************
 	 Dependencies:
 	  Global:
 	   core.pSimpleRelease
+	   core.commandTargets (w)
 	   core.targetCount
 	   core.error
 	   core.statusID
@@ -34,6 +38,7 @@ long coreSimpleRelease(unsigned char target, unsigned char localMove, void *pIns
 	***********************/
 	coreFormatArgumentType args;
 	coreCommandType *pSimpleCommand;
+	unsigned char previous;
 	
 	if(core.error) {
 		args.i[0] = target;
@@ -62,22 +67,30 @@ long coreSimpleRelease(unsigned char target, unsigned char localMove, void *pIns
 	
 	pSimpleCommand = core.pSimpleRelease + target - 1;
 	
-	if(GET_BIT(pSimpleCommand->status, CORE_COMMAND_BUSY) || GET_BIT(pSimpleCommand->status, CORE_COMMAND_PENDING)) {
-		args.i[0] = target;
-		args.i[1] = localMove;
-		logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_BUFFER), "Target simple release target %i local move %i rejected due to command in progress", &args);
-		return stCORE_ERROR_BUFFER;
-	}
-	
-	/* Share the command and assign the instance */
+	/* Claim the command, requests from any task class may compete for the same target */
+	do {
+		previous = pSimpleCommand->status;
+		if(GET_BIT(previous, CORE_COMMAND_BUSY) || GET_BIT(previous, CORE_COMMAND_PENDING) || GET_BIT(previous, CORE_COMMAND_RESERVED) || (GET_BIT(previous, CORE_COMMAND_CANCELLED) && !GET_BIT(previous, CORE_COMMAND_DONE))) {
+			args.i[0] = target;
+			args.i[1] = localMove;
+			logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_BUFFER), "Target simple release target %i local move %i rejected due to command in progress", &args);
+			return stCORE_ERROR_BUFFER;
+		}
+	} while(!__sync_bool_compare_and_swap(&pSimpleCommand->status, previous, 1U << CORE_COMMAND_RESERVED));
+	
+	/* Assign the instance and share a handle to this use of the command */
 	pSimpleCommand->pInstance = pInstance;
-	if(ppCommand != NULL) *ppCommand = pSimpleCommand;
+	coreCommandGeneration(pSimpleCommand);
+	if(pHandle != NULL) *pHandle = coreCommandHandle(pSimpleCommand);
 	
 	/* Write local move configuration index and set status */
 	pSimpleCommand->command.u1[0] = localMove; /* Store local move in first command byte */
-	CLEAR_BIT(pSimpleCommand->status, CORE_COMMAND_DONE);
-	CLEAR_BIT(pSimpleCommand->status, CORE_COMMAND_ERROR);
-	SET_BIT(pSimpleCommand->status, CORE_COMMAND_PENDING);
+	pSimpleCommand->requested = (unsigned long)AsIOTimeStamp();
+	pSimpleCommand->attempt = 0;
+	pSimpleCommand->claim = coreCommandHandle(pSimpleCommand); /* Allow cancel until sent */
+	__sync_synchronize(); /* Publish after the command is written */
+	pSimpleCommand->status = 1U << CORE_COMMAND_PENDING;
+	SET_BITMAP_ATOMIC(core.commandTargets, target - 1); /* Wake the command manager for this target */
 	
 	return 0;
 	
@@ -85,16 +98,20 @@ long coreSimpleRelease(unsigned char target, unsigned char localMove, void *pIns
 
 /* Release pallet to target */
 long StCoreReleasePallet(unsigned char Target, unsigned char Pallet, unsigned short Direction, unsigned char DestinationTarget) {
-	return coreReleasePallet(Target, Pallet, Direction, DestinationTarget, NULL, NULL);
+	unsigned long handle;
+	long status;
+	status = coreReleasePallet(Target, Pallet, Direction, DestinationTarget, NULL, &handle);
+	return status ? status : (long)handle; /* Command handle on success */
 }
 
 /* (Internal) release pallet to target */
-long coreReleasePallet(unsigned char target, unsigned char pallet, unsigned short direction, unsigned char destinationTarget, void *pInstance, coreCommandType **ppCommand) {
+long coreReleasePallet(unsigned char target, unsigned char pallet, unsigned short direction, unsigned char destinationTarget, void *pInstance, unsigned long *pHandle) {
 	
 	/************************************************
 	 Dependencies:
 	  Subroutines:
 	   coreCommandCreate
+	   coreCommandPack
 	   coreCommandRequest
 	************************************************/
 
@@ -115,15 +132,12 @@ long coreReleasePallet(unsigned char target, unsigned char pallet, unsigned shor
 	/**************
 	 Create command
 	**************/
-	memset(&command, 0, sizeof(command));
-	command.u1[0] = create.commandID;
-	command.u1[1] = create.context;
-	command.u1[2] = destinationTarget;
+	coreCommandPack(CORE_COMMAND_ID_RELEASE, &create, destinationTarget, 0.0, 0.0, &command);
 	
 	/***************
 	 Request command
 	***************/
-	status = coreCommandRequest(create.index, command, pInstance, ppCommand);
+	status = coreCommandRequest(create.index, command, pInstance, pHandle);
 	if(status)
 		return status;
 		
@@ -133,23 +147,27 @@ long coreReleasePallet(unsigned char target, unsigned char pallet, unsigned shor
 
 /* Release pallet to target + offset */
 long StCoreReleaseTargetOffset(unsigned char Target, unsigned char Pallet, unsigned short Direction, unsigned char DestinationTarget, double TargetOffset) {
-	return coreReleaseTargetOffset(Target, Pallet, Direction, DestinationTarget, TargetOffset, NULL, NULL);
+	unsigned long handle;
+	long status;
+	status = coreReleaseTargetOffset(Target, Pallet, Direction, DestinationTarget, TargetOffset, NULL, &handle);
+	return status ? status : (long)handle; /* Command handle on success */
 }
 
 /* (Internal) Release pallet to target + offset */
-long coreReleaseTargetOffset(unsigned char target, unsigned char pallet, unsigned short direction, unsigned char destinationTarget, double targetOffset, void *pInstance, coreCommandType **ppCommand) {
+long coreReleaseTargetOffset(unsigned char target, unsigned char pallet, unsigned short direction, unsigned char destinationTarget, double targetOffset, void *pInstance, unsigned long *pHandle) {
 	
 	/************************************************
 	 Dependencies:
 	  Subroutines:
 	   coreCommandCreate
+	   coreCommandPack
 	   coreCommandRequest
 	************************************************/
 
 	/***********************
 	 Declare local variables
 	***********************/
-	long status, offset;
+	long status;
 	coreCommandCreateType create;
 	SuperTrakCommand_t command;
 	
@@ -163,17 +181,12 @@ long coreReleaseTargetOffset(unsigned char target, unsigned char pallet, unsigne
 	/**************
 	 Create command
 	**************/
-	memset(&command, 0, sizeof(command));
-	command.u1[0] = create.commandID;
-	command.u1[1] = create.context;
-	command.u1[2] = destinationTarget;
-	offset = (long)(targetOffset * 1000.0);
-	memcpy(&command.u1[4], &offset, 4);
+	coreCommandPack(CORE_COMMAND_ID_OFFSET, &create, destinationTarget, targetOffset, 0.0, &command);
 	
 	/***************
 	 Request command
 	***************/
-	status = coreCommandRequest(create.index, command, pInstance, ppCommand);
+	status = coreCommandRequest(create.index, command, pInstance, pHandle);
 	if(status)
 		return status;
 	
@@ -183,23 +196,27 @@ long coreReleaseTargetOffset(unsigned char target, unsigned char pallet, unsigne
 
 /* Increment pallet offset */
 long StCoreReleaseIncrementalOffset(unsigned char Target, unsigned char Pallet, double IncrementalOffset) {
-	return coreReleaseIncrementalOffset(Target, Pallet, IncrementalOffset, NULL, NULL);
+	unsigned long handle;
+	long status;
+	status = coreReleaseIncrementalOffset(Target, Pallet, IncrementalOffset, NULL, &handle);
+	return status ? status : (long)handle; /* Command handle on success */
 }
 
 /* (Internal) Increment pallet offset */
-long coreReleaseIncrementalOffset(unsigned char target, unsigned char pallet, double incrementalOffset, void *pInstance, coreCommandType **ppCommand) {
+long coreReleaseIncrementalOffset(unsigned char target, unsigned char pallet, double incrementalOffset, void *pInstance, unsigned long *pHandle) {
 	
 	/************************************************
 	 Dependencies:
 	  Subroutines:
 	   coreCommandCreate
+	   coreCommandPack
 	   coreCommandRequest
 	************************************************/
 	
 	/***********************
 	 Declare local variables
 	***********************/
-	long status, offset;
+	long status;
 	coreCommandCreateType create;
 	SuperTrakCommand_t command;
 	
@@ -213,16 +230,12 @@ long coreReleaseIncrementalOffset(unsigned char target, unsigned char pallet, do
 	/**************
 	 Create command
 	**************/
-	memset(&command, 0, sizeof(command));
-	command.u1[0] = create.commandID;
-	command.u1[1] = create.context;
-	offset = (long)(incrementalOffset * 1000.0);
-	memcpy(&command.u1[4], &offset, 4);
+	coreCommandPack(CORE_COMMAND_ID_INCREMENT, &create, 0, incrementalOffset, 0.0, &command);
 	
 	/***************
 	 Request command
 	***************/
-	status = coreCommandRequest(create.index, command, pInstance, ppCommand);
+	status = coreCommandRequest(create.index, command, pInstance, pHandle);
 	if(status)
 		return status;
 	
@@ -232,16 +245,20 @@ long coreReleaseIncrementalOffset(unsigned char target, unsigned char pallet, do
 
 /* Resume pallet movement when at mandatory stop */
 long StCoreContinueMove(unsigned char Target, unsigned char Pallet) {
-	return coreContinueMove(Target, Pallet, NULL, NULL);
+	unsigned long handle;
+	long status;
+	status = coreContinueMove(Target, Pallet, NULL, &handle);
+	return status ? status : (long)handle; /* Command handle on success */
 }
 
 /* (Internal) Resume pallet movement when at mandatory stop */
-long coreContinueMove(unsigned char target, unsigned char pallet, void *pInstance, coreCommandType **ppCommand) {
+long coreContinueMove(unsigned char target, unsigned char pallet, void *pInstance, unsigned long *pHandle) {
 	
 	/************************************************
 	 Dependencies:
 	  Subroutines:
 	   coreCommandCreate
+	   coreCommandPack
 	   coreCommandRequest
 	************************************************/
 	
@@ -262,14 +279,12 @@ long coreContinueMove(unsigned char target, unsigned char pallet, void *pInstanc
 	/**************
 	 Create command
 	**************/
-	memset(&command, 0, sizeof(command));
-	command.u1[0] = create.commandID;
-	command.u1[1] = create.context;
+	coreCommandPack(CORE_COMMAND_ID_CONTINUE, &create, 0, 0.0, 0.0, &command);
 	
 	/***************
 	 Request command
 	***************/
-	status = coreCommandRequest(create.index, command, pInstance, ppCommand);
+	status = coreCommandRequest(create.index, command, pInstance, pHandle);
 	if(status)
 		return status;
 	
@@ -0,0 +1,82 @@
+/*******************************************************************************
+ * File: StCore\Retry.c
+ * Author: agent
+ * Date: 2026-10-17
+*******************************************************************************/
+
+#include "Main.h"
+#define LOG_OBJECT "Retry"
+
+/* Prototypes */
+static long logMessage(coreLogSeverityEnum severity, unsigned short code, char *message, coreFormatArgumentType *args);
+
+/* Return a failed or timed out command to pending if its retry policy allows, returns true if it will be sent again */
+unsigned char coreCommandRetry(coreCommandType *pCommand, coreCommandSelectEnum select, long result) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.commandStatistics (w)
+	   core.pSimpleRelease
+	   core.targetCount
+	   core.options
+	   core.cycleCount
+	  Subroutines:
+	   logMessage
+	   coreCommandDescribe
+	   coreCommandHandle
+	************************************************/
+	
+	/* Declare local variables */
+	StCoreCommandRetryType *pPolicy = &core.options.Command.Retry[select];
+	coreFormatArgumentType args;
+	unsigned long backoff;
+	
+	if(pCommand->attempt >= pPolicy->Attempts)
+		return false;
+	/* A timed out command may have executed, SuperTrak does not report it so a release can be sent twice */
+	if(result == stCORE_ERROR_TIMEOUT && !pPolicy->OnTimeout)
+		return false;
+	if(result == stCORE_ERROR_COMMAND && !pPolicy->OnError)
+		return false;
+	
+	/* Double the backoff for each further retry, wait at least one cycle so the cleared command reaches SuperTrak */
+	pCommand->attempt++;
+	backoff = MAX((unsigned long)pPolicy->Backoff << (pCommand->attempt - 1), 1);
+	pCommand->retry = core.cycleCount + backoff;
+	core.commandStatistics.command[select].retries++;
+	
+	/* Simple releases hold the local move configuration instead of command data */
+	if(core.pSimpleRelease <= pCommand && pCommand < core.pSimpleRelease + core.targetCount) {
+		args.i[0] = (long)(pCommand - core.pSimpleRelease) + 1;
+		args.i[1] = pCommand->command.u1[0];
+		args.i[2] = pCommand->attempt;
+		args.i[3] = pPolicy->Attempts;
+		args.i[4] = (long)backoff;
+		logMessage(CORE_LOG_SEVERITY_WARNING, coreLogCode(stCORE_WARNING_RETRY), "Target %i release from local move configuration %i retry %i of %i in %i cycles", &args);
+	}
+	else {
+		coreCommandDescribe(pCommand->command, &args);
+		args.i[1] = pCommand->attempt;
+		args.i[2] = pPolicy->Attempts;
+		args.i[3] = (long)backoff;
+		logMessage(CORE_LOG_SEVERITY_WARNING, coreLogCode(stCORE_WARNING_RETRY), "%s %i %s command retry %i of %i in %i cycles", &args);
+	}
+	
+	/* The command keeps its place and handle, the requester sees it pending again and may cancel it */
+	pCommand->claim = coreCommandHandle(pCommand);
+	__sync_synchronize();
+	pCommand->status = 1U << CORE_COMMAND_PENDING;
+	return true;
+	
+} /* End function */
+
+/* The pending command is not waiting for a retry backoff */
+unsigned char coreCommandReady(coreCommandType *pCommand) {
+	return pCommand->attempt == 0 || (long)(pCommand->retry - core.cycleCount) <= 0;
+}
+
+/* Create local logging function */
+long logMessage(coreLogSeverityEnum severity, unsigned short code, char *message, coreFormatArgumentType *args) {
+	return coreLog(core.ident, severity, CORE_LOGBOOK_FACILITY, code, LOG_OBJECT, message, args);
+}
@@ -21,6 +21,8 @@ void StCoreSection(StCoreSection_typ *inst) {
 	   core.pCyclicStatus
 	   core.interface
 	   core.sectionMap
+	   core.telemetry
+	   core.cycleCount
 	   core.error
 	   core.statusID
 	  Subroutines:
@@ -34,8 +36,8 @@ void StCoreSection(StCoreSection_typ *inst) {
 	static StCoreSection_typ *usedInst[CORE_SECTION_ADDRESS_MAX + 1];
 	coreFormatArgumentType args;
 	unsigned char *pSectionControl;
-	unsigned short *pSectionStatus, palletCount, hardwareSensors[CORE_SECTION_SENSOR_MAX];
-	unsigned long sectionPower;
+	unsigned short *pSectionStatus, *pSensors;
+	coreTelemetryEntryType *pEntry;
 	long i;
 	
 	/************
@@ -151,28 +153,28 @@ void StCoreSection(StCoreSection_typ *inst) {
 			/********************
 			 Extended Information
 			********************/
-			SuperTrakServChanRead(inst->Internal.Select, stPAR_SECTION_FAULTS_ACTIVE, 1, 1, (unsigned long)&inst->Info.Warnings, sizeof(inst->Info.Warnings));
-			SuperTrakServChanRead(inst->Internal.Select, stPAR_SECTION_FAULTS_ACTIVE, 0, 1, (unsigned long)&inst->Info.Faults, sizeof(inst->Info.Faults));
-			
-			SuperTrakServChanRead(inst->Internal.Select, stPAR_SECTION_PALLET_COUNT, 0, 1, (unsigned long)&palletCount, sizeof(palletCount));
-			inst->Info.PalletCount = (unsigned char)palletCount;
-			
-			SuperTrakServChanRead(inst->Internal.Select, stPAR_SECTION_LOAD_POWER, 0, 1, (unsigned long)&sectionPower, sizeof(sectionPower));
-			inst->Info.LoadPower = (float)sectionPower;
-			SuperTrakServChanRead(inst->Internal.Select, stPAR_SECTION_PEAK_POWER, 0, 1, (unsigned long)&sectionPower, sizeof(sectionPower));
-			inst->Info.PeakPower = (float)sectionPower;
-			SuperTrakServChanRead(inst->Internal.Select, 1393, 0, 1, (unsigned long)&sectionPower, sizeof(sectionPower));
-			inst->Info.AveragePower = (float)sectionPower;
-			
-			SuperTrakServChanRead(inst->Internal.Select, stPAR_HARDWARE_SENSORS, 0, CORE_SECTION_SENSOR_MAX, (unsigned long)&hardwareSensors, sizeof(hardwareSensors));
+			/* Copy from section telemetry read by StCoreCyclic */
+			pEntry = &core.telemetry.entry[core.sectionMap[inst->Internal.Select]];
+			inst->Info.Warnings = pEntry->warnings;
+			inst->Info.Faults = pEntry->faults;
+			inst->Info.PalletCount = (unsigned char)pEntry->palletCount;
+			inst->Info.LoadPower = (float)pEntry->loadPower;
+			inst->Info.PeakPower = (float)pEntry->peakPower;
+			inst->Info.AveragePower = (float)pEntry->averagePower;
+			if(pEntry->valid)
+				inst->Info.Age = (core.cycleCount - pEntry->cycle) * CORE_CYCLE_TIME / 1000;
+			else
+				inst->Info.Age = ULONG_MAX;
+			
+			pSensors = pEntry->sensors;
 			for(i = 0; i < 5; i++) {
-				inst->Info.Left.MotorTemp[i] = ((float)hardwareSensors[i]) / 100.0;
-				inst->Info.Right.MotorTemp[i] = ((float)hardwareSensors[8 + i]) / 100.0;
+				inst->Info.Left.MotorTemp[i] = ((float)pSensors[i]) / 100.0;
+				inst->Info.Right.MotorTemp[i] = ((float)pSensors[8 + i]) / 100.0;
 			}
-			inst->Info.Left.ElectronicsTemp = ((float)hardwareSensors[5]) / 100.0;
-			inst->Info.Left.MotorVoltage = ((float)hardwareSensors[6]) / 100.0;
-			inst->Info.Right.ElectronicsTemp = ((float)hardwareSensors[13]) / 100.0;
-			inst->Info.Right.MotorVoltage = ((float)hardwareSensors[14]) / 100.0;
+			inst->Info.Left.ElectronicsTemp = ((float)pSensors[5]) / 100.0;
+			inst->Info.Left.MotorVoltage = ((float)pSensors[6]) / 100.0;
+			inst->Info.Right.ElectronicsTemp = ((float)pSensors[13]) / 100.0;
+			inst->Info.Right.MotorVoltage = ((float)pSensors[14]) / 100.0;
 			
 			/* Allow warning reset */
 			if(inst->ErrorReset && !inst->Internal.PreviousErrorReset)
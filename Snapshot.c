@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * File: StCore\Snapshot.c
+ * Author: agent
+ * Date: 2026-10-17
+*******************************************************************************/
+
+#include "Main.h"
+
+/* Publish a consistent copy of cyclic status and pallet data for lower priority tasks */
+void coreSnapshotPublish(void) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.snapshot (w)
+	   core.options
+	   core.pCyclicStatus
+	   core.pPalletData
+	   core.palletMap
+	   core.interface
+	   core.palletCount
+	   core.cycleCount
+	************************************************/
+	
+	/* Declare local variables */
+	coreSnapshotType *pSnapshot = &core.snapshot;
+	
+	/* Snapshot option is not selected or memory is not allocated */
+	if(!core.options.Snapshot || pSnapshot->pCyclicStatus == NULL || pSnapshot->pPalletData == NULL || core.pCyclicStatus == NULL || core.pPalletData == NULL)
+		return;
+	
+	/* An odd sequence tells readers the snapshot is being written */
+	pSnapshot->sequence++;
+	__sync_synchronize();
+	
+	memcpy(pSnapshot->pCyclicStatus, core.pCyclicStatus, core.interface.statusSize);
+	memcpy(pSnapshot->pPalletData, core.pPalletData, sizeof(SuperTrakPalletInfo_t) * core.palletCount);
+	memcpy(pSnapshot->palletMap, core.palletMap, sizeof(pSnapshot->palletMap));
+	pSnapshot->cycle = core.cycleCount;
+	pSnapshot->timestamp = (unsigned long)AsIOTimeStamp();
+	
+	__sync_synchronize();
+	pSnapshot->sequence++;
+	
+} /* End function */
+
+/* Begin reading the snapshot, returns the sequence to verify with coreSnapshotRetry */
+unsigned long coreSnapshotBegin(void) {
+	
+	/* Declare local variables */
+	unsigned long sequence;
+	
+	/* StCoreCyclic completes the write before a lower priority task resumes */
+	do {
+		sequence = core.snapshot.sequence;
+	} while(sequence % 2);
+	
+	__sync_synchronize();
+	return sequence;
+	
+} /* End function */
+
+/* The snapshot was published again during the read and the read must be repeated */
+unsigned char coreSnapshotRetry(unsigned long sequence) {
+	__sync_synchronize();
+	return core.snapshot.sequence != sequence;
+}
@@ -5,6 +5,46 @@
 *******************************************************************************)
 
 TYPE
+	StCoreOptionsType : 	STRUCT  (*Optional StCoreInit configuration, zero values select defaults*)
+		FaultMonitor : StCoreFaultMonitorOptionsType; (*SuperTrak fault and warning logging*)
+		Parameter : StCoreParameterOptionsType; (*Service channel parameter refresh periods*)
+		Telemetry : StCoreTelemetryOptionsType; (*Section parameters read by StCoreCyclic*)
+		Command : StCoreCommandOptionsType; (*Command nodes shared by all pallets and channel scheduling*)
+		Snapshot : BOOL; (*StCoreTargetStatus and StCorePalletStatus read a consistent copy published at the end of StCoreCyclic*)
+	END_STRUCT;
+	StCoreFaultMonitorOptionsType : 	STRUCT  (*Fault monitor options*)
+		ReadBudget : USINT; (*Maximum fault instance reads per cycle (0 for default 2)*)
+		SweepPeriod : UDINT; (*ms Period to read all system and section fault instances in the background (0 for default 1000)*)
+	END_STRUCT;
+	StCoreParameterOptionsType : 	STRUCT  (*Refresh periods of parameters shared by status functions*)
+		Pallet : UDINT; (*ms Pallet velocity, destination, and setpoints (0 for every scan)*)
+		Target : UDINT; (*ms Target section, position, and pallet destinations (0 for every scan)*)
+		Fault : UDINT; (*ms System active faults and warnings (0 for every scan)*)
+		Power : UDINT; (*ms System power (0 for default 1000)*)
+	END_STRUCT;
+	StCoreTelemetryOptionsType : 	STRUCT  (*Section telemetry options*)
+		ReadBudget : USINT; (*Maximum section parameter reads per cycle, seven reads per section (0 for default 4)*)
+	END_STRUCT;
+	StCoreCommandOptionsType : 	STRUCT  (*Command pool and scheduler options*)
+		PoolSize : UINT; (*Command nodes shared by all pallets, maximum 4096 (0 for default 2 per pallet)*)
+		PalletCap : USINT; (*Maximum commands requested and not yet done per pallet (0 for default 4)*)
+		Scheduler : USINT; (*Channel assignment policy, see stCORE_SCHEDULER constants (0 for pallet order)*)
+		AgingTime : UDINT; (*ms Priority scheduler wait before a configuration command is assigned with release priority (0 for default 20, at most 50000)*)
+		Coalesce : BOOL; (*A pending motion, mechanical, or control parameter command is replaced by the next request of the same kind*)
+		Timeout : ARRAY[0..8]OF StCoreCommandTimeoutType; (*Adaptive timeout per command, see stCORE_COMMAND constants (0 for simple release)*)
+		Retry : ARRAY[0..8]OF StCoreCommandRetryType; (*Retry policy per command, see stCORE_COMMAND constants (0 for simple release)*)
+	END_STRUCT;
+	StCoreCommandRetryType : 	STRUCT  (*Command retry policy, applied before an error is reported to the requester, except to grouped commands*)
+		Attempts : USINT; (*Maximum retries after the first attempt, maximum 8 (0 for no retry)*)
+		OnTimeout : BOOL; (*Retry when SuperTrak does not respond within the timeout, a release SuperTrak already executed may be sent again*)
+		OnError : BOOL; (*Retry when SuperTrak responds with error*)
+		Backoff : UINT; (*Cycles to wait before the first retry, doubled for each further retry (0 for next cycle)*)
+	END_STRUCT;
+	StCoreCommandTimeoutType : 	STRUCT  (*Adaptive command timeout, a multiple of the 99th percentile response time within limits*)
+		Floor : UDINT; (*ms Minimum timeout (0 for default 100, or the ceiling if lower)*)
+		Ceiling : UDINT; (*ms Maximum timeout, used until enough responses are observed (0 for default 500, maximum 600000)*)
+		Factor : REAL; (*Multiple of the 99th percentile response time (0 for default 4)*)
+	END_STRUCT;
 	StCoreSystemInfoType : 	STRUCT  (*Extended system information*)
 		Warnings : UDINT; (*(Par 1460) Active SuperTrak system warnings*)
 		Faults : UDINT; (*(Par 1460) Active SuperTrak system faults*)
@@ -28,6 +68,7 @@ TYPE
 		LoadPower : REAL; (*W (Par 1391) Estimated instantaneous power consumption*)
 		PeakPower : REAL; (*W (Par 1392) Largest observed instantaneous power value*)
 		AveragePower : REAL; (*W (Par 1393) Average power consumption*)
+		Age : UDINT; (*ms Time since the extended information was read, 4294967295 until the first read*)
 	END_STRUCT;
 	StCoreSectionInfoSensorType : 	STRUCT  (*Section temperature and power readings*)
 		MotorTemp : ARRAY[0..4]OF REAL; (*Deg C (Par 1570) Temperature readings from motor coil sensors*)
@@ -40,8 +81,14 @@ TYPE
 		PreviousSelect : USINT; (*Previous select index value*)
 		PreviousErrorReset : BOOL; (*Previous ErrorReset value*)
 		PreviousCommand : UINT; (*Previous command inputs bitwise*)
-		CommandSelect : USINT; (*Active command index*)
-		pCommand : UDINT; (*Address of buffered core command*)
+		Handle : ARRAY[0..8]OF UDINT; (*Handle of the requested command per command index, 0 if none*)
+	END_STRUCT;
+	StCoreCommandProgressType : 	STRUCT  (*Progress of one command input of a function block*)
+		Busy : BOOL; (*The command request is executing*)
+		Acknowledged : BOOL; (*The command request has successfully acknowledged*)
+		Error : BOOL; (*The command request failed, see StatusID*)
+		Superseded : BOOL; (*The command request was acknowledged without being sent because a newer request of the same kind replaced it*)
+		Cancelled : BOOL; (*The command request was acknowledged without being sent because it was cancelled*)
 	END_STRUCT;
 	StCoreTargetParameterType : 	STRUCT  (*Target interface parameters*)
 		Release : StCoreReleaseParameterType; (*Release command parameters*)
@@ -56,6 +103,12 @@ TYPE
 		Mechanical : StCoreMechanicalParameterType; (*Mechanical parameters for configuration command*)
 		Control : StCoreControlParameterType; (*Control parameters for configuration command*)
 	END_STRUCT;
+	StCoreCommandType : 	STRUCT  (*Command submitted by StCoreCommandBatch*)
+		Command : USINT; (*Command to submit (see stCORE_COMMAND constants)*)
+		Target : USINT; (*Target (with pallet present), 0 for pallet context*)
+		Pallet : USINT; (*Pallet ID when target is 0*)
+		Parameters : StCoreTargetParameterType; (*Command parameters*)
+	END_STRUCT;
 	StCoreReleaseParameterType : 	STRUCT  (*Release command parameter structure*)
 		Direction : UINT := stDIRECTION_RIGHT; (*Direction of motion (stDIRECTION_RIGHT or stDIRECTION_LEFT)*)
 		DestinationTarget : USINT := 1; (*Destination target*)
@@ -79,6 +132,8 @@ TYPE
 		Position : LREAL; (*mm (Derived) Target section position*)
 		PositionUm : DINT; (*um (Par 1651) Target integer section position*)
 		PalletCount : USINT; (*(Derived) The number of pallets destined to this target*)
+		Cycle : UDINT; (*StCoreCyclic call count of the status data*)
+		Age : UDINT; (*us Time since the snapshot was published (0 without the snapshot option)*)
 	END_STRUCT;
 	StCoreTargetStatusType : 	STRUCT  (*Target status information*)
 		PalletPresent : BOOL; (*(IF) A pallet has arrived, entered the in-position window, and is not yet released*)
@@ -99,6 +154,8 @@ TYPE
 		SetPositionUm : DINT; (*um (Par 1311) Pallet position setpoint*)
 		SetVelocity : REAL; (*mm/s (Par 1313) Pallet velocity setpoint*)
 		SetAcceleration : REAL; (*mm/s/s (Par 1312) Pallet acceleration setpoint*)
+		Cycle : UDINT; (*StCoreCyclic call count of the status data*)
+		Age : UDINT; (*us Time since the snapshot was published (0 without the snapshot option)*)
 	END_STRUCT;
 	StCorePalletStatusType : 	STRUCT  (*Pallet status information*)
 		Present : BOOL; (*(Par 1328) Pallet is present on the system*)
@@ -112,4 +169,77 @@ TYPE
 		Position : LREAL; (*mm (Par 1310) Actual pallet position*)
 		Info : StCorePalletInfoType; (*Extended pallet status information*)
 	END_STRUCT;
+	StCorePalletEventType : 	STRUCT  (*Pallet change event*)
+		Sequence : UDINT; (*Event sequence number*)
+		Cycle : UDINT; (*StCoreCyclic call count when the change was detected*)
+		Event : USINT; (*stCORE_PALLET_APPEARED, stCORE_PALLET_DISAPPEARED, or stCORE_PALLET_ID_CHANGED*)
+		Index : USINT; (*Offset of the pallet in the memory structure*)
+		PalletID : USINT; (*Pallet ID after the change, 0 for unidentified*)
+		PreviousPalletID : USINT; (*Pallet ID before the change, 0 for unidentified*)
+	END_STRUCT;
+	StCoreCommandEventType : 	STRUCT  (*Command completion event*)
+		Sequence : UDINT; (*Event sequence number*)
+		Cycle : UDINT; (*StCoreCyclic call count when the command completed*)
+		Handle : UDINT; (*Handle returned when the command was requested*)
+		Instance : UDINT; (*Address of the requesting function block instance, 0 for function calls*)
+		Command : USINT; (*stCORE_COMMAND constant, 0 for simple release*)
+		CommandID : USINT; (*SuperTrak command ID, or local move configuration for simple release*)
+		Context : USINT; (*Target or pallet of the command*)
+		Result : DINT; (*0 if acknowledged, stCORE_ERROR_COMMAND, stCORE_ERROR_TIMEOUT, or stCORE_WARNING_CANCELLED*)
+		Latency : UDINT; (*us Time from request to completion, or to removal of a cancelled command*)
+	END_STRUCT;
+	StCoreTimingType : 	STRUCT  (*Execution time statistics*)
+		Last : UDINT; (*us Most recent execution time*)
+		Min : UDINT; (*us Minimum execution time*)
+		Max : UDINT; (*us Maximum execution time*)
+		Mean : REAL; (*us Average execution time*)
+		Count : UDINT; (*Number of recorded executions*)
+		Histogram : ARRAY[0..7]OF UDINT; (*Execution count in buckets [0, 10), [10, 20), [20, 50), [50, 100), [100, 200), [200, 400), [400, 800), and 800+ us*)
+	END_STRUCT;
+	StCoreLatencyType : 	STRUCT  (*Command latency statistics*)
+		Last : UDINT; (*us Most recent latency*)
+		Min : UDINT; (*us Minimum latency*)
+		Max : UDINT; (*us Maximum latency*)
+		Mean : REAL; (*us Average latency*)
+		Count : UDINT; (*Number of recorded commands*)
+		Histogram : ARRAY[0..7]OF UDINT; (*Command count in buckets [0, 0.8), [0.8, 1.6), [1.6, 4), [4, 8), [8, 16), [16, 40), [40, 80), and 80+ ms*)
+	END_STRUCT;
+	StCoreCommandStatisticsType : 	STRUCT  (*Command latency and failures of one command*)
+		QueueWait : StCoreLatencyType; (*Time from request to assignment of a command channel*)
+		Execution : StCoreLatencyType; (*Time from assignment of a command channel to acknowledgement or error from SuperTrak*)
+		Timeouts : UDINT; (*Commands without response from SuperTrak*)
+		Errors : UDINT; (*Commands SuperTrak responded to with error*)
+		Timeout : UDINT; (*us Current adaptive timeout*)
+		Retries : UDINT; (*Failures and timeouts sent again by the retry policy*)
+		Recovered : UDINT; (*Commands acknowledged after at least one retry*)
+		Cancelled : UDINT; (*Commands cancelled by the requester before they were sent*)
+	END_STRUCT;
+	StCoreCyclicDiagnosticsType : 	STRUCT  (*StCoreCyclic execution diagnostics*)
+		CycleCount : UDINT; (*Number of StCoreCyclic calls*)
+		Overruns : UDINT; (*Number of StCoreCyclic calls exceeding the 800 us cycle time*)
+		Total : StCoreTimingType; (*StCoreCyclic execution time*)
+		CommandManager : StCoreTimingType; (*Command buffer and channel processing*)
+		ProcessControl : StCoreTimingType; (*SuperTrakProcessControl*)
+		Cyclic1 : StCoreTimingType; (*SuperTrakCyclic1*)
+		ProcessStatus : StCoreTimingType; (*SuperTrakProcessStatus*)
+		FaultMonitor : StCoreTimingType; (*SuperTrak fault and warning logging*)
+		SectionTelemetry : StCoreTimingType; (*Section parameter reads*)
+		PalletManager : StCoreTimingType; (*Pallet information and mapping*)
+	END_STRUCT;
+	StCoreFaultDiagnosticsType : 	STRUCT  (*Fault monitor diagnostics*)
+		Reads : UDINT; (*Fault instance reads due to system or section warning/fault status changes*)
+		SweepReads : UDINT; (*Fault instance reads from the background sweep*)
+		Pending : USINT; (*System and sections waiting for read budget*)
+	END_STRUCT;
+	StCoreLogDiagnosticsType : 	STRUCT  (*Deferred logging diagnostics*)
+		Deferred : UDINT; (*Log records deferred by StCoreCyclic*)
+		Pending : UDINT; (*Log records waiting for StCoreLogFlush*)
+		Dropped : UDINT; (*Log records dropped because StCoreLogFlush did not keep up*)
+	END_STRUCT;
+	StCoreCommandDiagnosticsType : 	STRUCT  (*Command pool diagnostics*)
+		PoolSize : UDINT; (*Command nodes shared by all pallets*)
+		Used : UDINT; (*Command nodes requested and not yet done*)
+		HighWater : UDINT; (*Most command nodes in use at once*)
+		Rejected : UDINT; (*Command requests rejected because all nodes were in use*)
+	END_STRUCT;
 END_TYPE
@@ -0,0 +1,160 @@
+/*******************************************************************************
+ * File: StCore\Statistics.c
+ * Author: agent
+ * Date: 2026-10-17
+*******************************************************************************/
+
+#include "Main.h"
+
+/* Prototypes */
+static void resetOutput(StCoreCommandStatistics_typ *inst);
+static void copyLatency(StCoreLatencyType *pLatency, coreTimingType *pSource);
+
+/* Upper limit of each latency bucket in microseconds, the last bucket has no limit */
+static const unsigned long bucketLimit[CORE_TIMING_BUCKET_COUNT - 1] = {CORE_CYCLE_TIME, 2 * CORE_CYCLE_TIME, 5 * CORE_CYCLE_TIME, 10 * CORE_CYCLE_TIME, 20 * CORE_CYCLE_TIME, 50 * CORE_CYCLE_TIME, 100 * CORE_CYCLE_TIME};
+
+/* Get the command selection from a SuperTrak command ID */
+coreCommandSelectEnum coreCommandSelect(unsigned char commandID) {
+	if(CORE_COMMAND_ID_RELEASE <= commandID && commandID <= CORE_COMMAND_ID_RELEASE + 3)
+		return CORE_COMMAND_RELEASE;
+	else if(CORE_COMMAND_ID_OFFSET <= commandID && commandID <= CORE_COMMAND_ID_OFFSET + 3)
+		return CORE_COMMAND_OFFSET;
+	else if(CORE_COMMAND_ID_INCREMENT <= commandID && commandID <= CORE_COMMAND_ID_INCREMENT + 3)
+		return CORE_COMMAND_INCREMENT;
+	else if(CORE_COMMAND_ID_CONTINUE <= commandID && commandID <= CORE_COMMAND_ID_CONTINUE + 3)
+		return CORE_COMMAND_CONTINUE;
+	else if(commandID == CORE_COMMAND_ID_PALLET_ID)
+		return CORE_COMMAND_ID;
+	else if(CORE_COMMAND_ID_MOTION <= commandID && commandID <= CORE_COMMAND_ID_MOTION + 3)
+		return CORE_COMMAND_MOTION;
+	else if(CORE_COMMAND_ID_MECHANICAL <= commandID && commandID <= CORE_COMMAND_ID_MECHANICAL + 3)
+		return CORE_COMMAND_MECHANICAL;
+	else
+		return CORE_COMMAND_CONTROL;
+}
+
+/* Stamp a command written to the control interface and record its time waiting in queue */
+void coreCommandAssigned(coreCommandType *pCommand, coreCommandSelectEnum select) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.commandStatistics (w)
+	  Subroutines:
+	   coreTimingAdd
+	************************************************/
+	
+	pCommand->assigned = (unsigned long)AsIOTimeStamp();
+	if(pCommand->attempt == 0) /* A retry has already waited */
+		coreTimingAdd(&core.commandStatistics.command[select].queue, pCommand->assigned - pCommand->requested, bucketLimit); /* Unsigned difference is valid across timestamp rollover */
+	
+} /* End function */
+
+/* Record the execution time, timeout, or cancellation of a command and publish its completion event */
+void coreCommandFinished(coreCommandType *pCommand, coreCommandSelectEnum select, long result) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.commandStatistics (w)
+	  Subroutines:
+	   coreTimingAdd
+	   coreCommandLatency
+	   coreCommandEvent
+	************************************************/
+	
+	/* Declare local variables */
+	unsigned long now;
+	
+	now = (unsigned long)AsIOTimeStamp();
+	
+	if(result == stCORE_WARNING_CANCELLED)
+		core.commandStatistics.command[select].cancelled++; /* Never sent, there is no execution time */
+	else if(result == stCORE_ERROR_TIMEOUT) {
+		core.commandStatistics.command[select].timeouts++;
+		coreCommandLatency(select, now - pCommand->assigned); /* Record at the elapsed timeout so p99 rises once timeouts exceed 1% */
+	}
+	else {
+		coreTimingAdd(&core.commandStatistics.command[select].execution, now - pCommand->assigned, bucketLimit);
+		coreCommandLatency(select, now - pCommand->assigned); /* Every response adapts the timeout */
+		if(result)
+			core.commandStatistics.command[select].errors++;
+		else if(pCommand->attempt)
+			core.commandStatistics.command[select].recovered++;
+	}
+	
+	coreCommandEvent(pCommand, select, result, now - pCommand->requested);
+	
+} /* End function */
+
+/* StCore command latency interface */
+void StCoreCommandStatistics(StCoreCommandStatistics_typ *inst) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.commandStatistics (w)
+	  Subroutines:
+	   resetOutput
+	   copyLatency
+	   coreCommandTimeout
+	************************************************/
+	
+	/* Declare local variables */
+	coreCommandLatencyType *pSource;
+	unsigned char i;
+	
+	/* Interrupt if disabled */
+	if(inst->Enable == false)
+		inst->Internal.State = CORE_FUNCTION_DISABLED;
+	
+	switch(inst->Internal.State) {
+		case CORE_FUNCTION_DISABLED:
+			resetOutput(inst);
+			if(inst->Enable)
+				inst->Internal.State = CORE_FUNCTION_EXECUTING;
+			break;
+		
+		default:
+			/* Request reset on rising edge, StCoreCyclic clears the statistics on its next call */
+			if(inst->Reset && !GET_BIT(inst->Internal.PreviousCommand, 0))
+				core.commandStatistics.reset = true;
+			
+			/* Statistics remain available during a critical error in StCore */
+			for(i = 0; i < CORE_COMMAND_SELECT_COUNT; i++) {
+				pSource = &core.commandStatistics.command[i];
+				copyLatency(&inst->Command[i].QueueWait, &pSource->queue);
+				copyLatency(&inst->Command[i].Execution, &pSource->execution);
+				inst->Command[i].Timeouts = pSource->timeouts;
+				inst->Command[i].Errors = pSource->errors;
+				inst->Command[i].Retries = pSource->retries;
+				inst->Command[i].Recovered = pSource->recovered;
+				inst->Command[i].Cancelled = pSource->cancelled;
+				inst->Command[i].Timeout = coreCommandTimeout((coreCommandSelectEnum)i) * CORE_CYCLE_TIME;
+			}
+			
+			inst->Valid = true;
+			break;
+	}
+	
+	coreAssign16(&inst->Internal.PreviousCommand, 0, inst->Reset);
+	
+} /* End function */
+
+/* Clear instance outputs */
+void resetOutput(StCoreCommandStatistics_typ *inst) {
+	inst->Valid = false;
+	inst->Error = false;
+	inst->StatusID = 0;
+	memset(&inst->Command, 0, sizeof(inst->Command));
+}
+
+/* Copy internal latency statistics to user structure */
+void copyLatency(StCoreLatencyType *pLatency, coreTimingType *pSource) {
+	pLatency->Last = pSource->last;
+	pLatency->Min = pSource->min;
+	pLatency->Max = pSource->max;
+	pLatency->Count = pSource->count;
+	pLatency->Mean = pSource->count ? (float)(pSource->total / (double)pSource->count) : 0.0;
+	memcpy(pLatency->Histogram, pSource->histogram, sizeof(pLatency->Histogram));
+}
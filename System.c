@@ -23,9 +23,11 @@ void StCoreSystem(StCoreSystem_typ *inst) {
 	   core.error
 	   core.statusID
 	   core.debug (w)
+	   core.parameters
 	  Subroutines:
 	   resetOutput
 	   logMessage
+	   coreParameterRefresh
 	************************************************/
 	
 	/***********************
@@ -35,7 +37,7 @@ void StCoreSystem(StCoreSystem_typ *inst) {
 	unsigned short *pSystemControl, *pSystemStatus;
 	long i;
 	unsigned short *pSectionStatus;
-	unsigned long systemPower;
+	coreParameterCacheType *pCache = &core.parameters;
 	static RTInfo_typ fbRTInfo;
 	static unsigned long timer;
 	
@@ -136,15 +138,14 @@ void StCoreSystem(StCoreSystem_typ *inst) {
 			inst->PalletCount = (unsigned char)(*(pSystemStatus + 1)); /* Access the next 16 bits */
 			
 			/* Extended information */
-			SuperTrakServChanRead(0, stPAR_SYSTEM_FAULTS_ACTIVE, 1, 1, (unsigned long)&inst->Info.Warnings, sizeof(inst->Info.Warnings));
-			SuperTrakServChanRead(0, stPAR_SYSTEM_FAULTS_ACTIVE, 0, 1, (unsigned long)&inst->Info.Faults, sizeof(inst->Info.Faults));
+			coreParameterRefresh(CORE_PARAMETER_FAULT);
+			inst->Info.Warnings = pCache->warnings;
+			inst->Info.Faults = pCache->faults;
 			
-			SuperTrakServChanRead(0, stPAR_SYSTEM_LOAD_POWER, 0, 1, (unsigned long)&systemPower, sizeof(systemPower));
-			inst->Info.LoadPower = (float)systemPower;
-			SuperTrakServChanRead(0, stPAR_SYSTEM_PEAK_POWER, 0, 1, (unsigned long)&systemPower, sizeof(systemPower));
-			inst->Info.PeakPower = (float)systemPower;
-			SuperTrakServChanRead(0, stPAR_SYSTEM_AVERAGE_POWER, 0, 1, (unsigned long)&systemPower, sizeof(systemPower));
-			inst->Info.AveragePower = (float)systemPower;
+			coreParameterRefresh(CORE_PARAMETER_POWER);
+			inst->Info.LoadPower = (float)pCache->loadPower;
+			inst->Info.PeakPower = (float)pCache->peakPower;
+			inst->Info.AveragePower = (float)pCache->averagePower;
 			
 			/* Section information */
 			inst->Info.SectionCount = core.interface.sectionCount;
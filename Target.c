@@ -11,7 +11,7 @@
 static long logMessage(coreLogSeverityEnum severity, unsigned short code, char *message, coreFormatArgumentType *args);
 static void resetOutput(StCoreTarget_typ *inst);
 static void activateCommand(StCoreTarget_typ *inst, unsigned char select);
-static void resetCommand(StCoreTarget_typ *inst);
+static void resetCommand(StCoreTarget_typ *inst, unsigned char select);
 static void recordInput(StCoreTarget_typ *inst, unsigned short *pData);
 static void controlError(StCoreTarget_typ *inst, long status);
 static void statusError(StCoreTarget_typ *inst, long status);
@@ -26,21 +26,26 @@ long StCoreTargetStatus(unsigned char Target, StCoreTargetStatusType *Status) {
 	   core.interface
 	   core.targetCount
 	   core.palletCount
+	   core.parameters
+	   core.snapshot
+	   core.options
 	   core.error
 	   core.statusID
 	  Subroutines:
 	   resetOutput
 	   logMessage
+	   coreParameterRefresh
+	   coreSnapshotBegin
+	   coreSnapshotRetry
 	************************************************/
 	
 	/*********************** 
 	 Declare Local Variables
 	***********************/
-	unsigned char *pTargetStatus;
+	unsigned char targetStatus[CORE_TARGET_STATUS_BYTE_COUNT];
 	long i;
-	static long timestamp;
-	static unsigned short targetSection[CORE_TARGET_MAX], destinationTarget[CORE_PALLET_MAX];
-	static long targetPosition[CORE_TARGET_MAX];
+	coreParameterCacheType *pCache = &core.parameters;
+	unsigned long sequence, offset, timestamp;
 	
 	/* Clear status structure */
 	memset(Status, 0, sizeof(*Status));
@@ -57,38 +62,48 @@ long StCoreTargetStatus(unsigned char Target, StCoreTargetStatusType *Status) {
 		return stCORE_ERROR_INDEX;
 	
 	/* Check reference */
-	if(core.pCyclicStatus == NULL)
+	if(core.pCyclicStatus == NULL || (core.options.Snapshot && core.snapshot.pCyclicStatus == NULL))
 		return stCORE_ERROR_ALLOCATION;
 	
 	/**********
 	 Set Status
 	**********/
-	pTargetStatus = core.pCyclicStatus + core.interface.targetStatusOffset + 3 * Target;
+	/* Copy the target status bytes, repeat if StCoreCyclic publishes a new snapshot during the copy */
+	offset = core.interface.targetStatusOffset + CORE_TARGET_STATUS_BYTE_COUNT * Target;
+	if(core.options.Snapshot) {
+		do {
+			sequence = coreSnapshotBegin();
+			memcpy(targetStatus, core.snapshot.pCyclicStatus + offset, sizeof(targetStatus));
+			Status->Info.Cycle = core.snapshot.cycle;
+			timestamp = core.snapshot.timestamp;
+		} while(coreSnapshotRetry(sequence));
+		Status->Info.Age = (unsigned long)AsIOTimeStamp() - timestamp;
+	}
+	else {
+		memcpy(targetStatus, core.pCyclicStatus + offset, sizeof(targetStatus));
+		Status->Info.Cycle = core.cycleCount;
+	}
 	
-	Status->PalletPresent = GET_BIT(*pTargetStatus, stTARGET_PALLET_PRESENT);
-	Status->PalletInPosition = GET_BIT(*pTargetStatus, stTARGET_PALLET_IN_POSITION);
-	Status->PalletPreArrival = GET_BIT(*pTargetStatus, stTARGET_PALLET_PRE_ARRIVAL);
-	Status->PalletOverTarget = GET_BIT(*pTargetStatus, stTARGET_PALLET_OVER);
-	Status->PalletPositionUncertain = GET_BIT(*pTargetStatus, stTARGET_PALLET_POS_UNCERTAIN);
+	Status->PalletPresent = GET_BIT(targetStatus[0], stTARGET_PALLET_PRESENT);
+	Status->PalletInPosition = GET_BIT(targetStatus[0], stTARGET_PALLET_IN_POSITION);
+	Status->PalletPreArrival = GET_BIT(targetStatus[0], stTARGET_PALLET_PRE_ARRIVAL);
+	Status->PalletOverTarget = GET_BIT(targetStatus[0], stTARGET_PALLET_OVER);
+	Status->PalletPositionUncertain = GET_BIT(targetStatus[0], stTARGET_PALLET_POS_UNCERTAIN);
 	
-	Status->PalletID = *(core.pCyclicStatus + core.interface.targetStatusOffset + CORE_TARGET_STATUS_BYTE_COUNT * Target + 1);
+	Status->PalletID = targetStatus[1];
 	
-	/* Pull new data on new scan */
-	if(timestamp != AsIOTimeCyclicStart()) {
-		timestamp = AsIOTimeCyclicStart();
-		SuperTrakServChanRead(0, stPAR_TARGET_SECTION, 0, core.targetCount, (unsigned long)&targetSection, sizeof(targetSection));
-		SuperTrakServChanRead(0, stPAR_TARGET_POSITION, 0, core.targetCount, (unsigned long)&targetPosition, sizeof(targetPosition));
-		SuperTrakServChanRead(0, 1339, 0, core.palletCount, (unsigned long)&destinationTarget, sizeof(destinationTarget));
-	}
+	/* Refresh shared parameters */
+	coreParameterRefresh(CORE_PARAMETER_TARGET);
+	coreParameterRefresh(CORE_PARAMETER_DESTINATION);
 	
 	/* Target section and position */
-	Status->Info.Section = (unsigned char)targetSection[Target];
-	Status->Info.PositionUm = targetPosition[Target];
-	Status->Info.Position = ((double)targetPosition[Target]) / 1000.0; /* um to mm */
+	Status->Info.Section = (unsigned char)pCache->targetSection[Target];
+	Status->Info.PositionUm = pCache->targetPosition[Target];
+	Status->Info.Position = ((double)pCache->targetPosition[Target]) / 1000.0; /* um to mm */
 	
 	/* Aggregate pallet count */
 	for(i = 0; i < core.palletCount; i++) {
-		if((unsigned char)destinationTarget[i] == Target) 
+		if((unsigned char)pCache->palletDestination[i] == Target) 
 			Status->Info.PalletCount++;
 	}
 	
@@ -117,7 +132,8 @@ void StCoreTarget(StCoreTarget_typ *inst) {
 	long status;
 	StCoreTargetStatusType targetStatus;
 	unsigned short input;
-	coreCommandType *pCommand;
+	unsigned char commandStatus, select;
+	StCoreCommandProgressType *pCommand;
 	
 	/************
 	 Switch State
@@ -177,7 +193,7 @@ void StCoreTarget(StCoreTarget_typ *inst) {
 			/* Set pallet ID */
 			if(inst->SetPalletID && !GET_BIT(inst->Internal.PreviousCommand, CORE_COMMAND_ID)) {
 				/* Run and activate */
-				status = coreSetPalletID(inst->Internal.Select, inst->Parameters.PalletID, (void*)inst, (coreCommandType**)&inst->Internal.pCommand);
+				status = coreSetPalletID(inst->Internal.Select, inst->Parameters.PalletID, (void*)inst, &inst->Internal.Handle[CORE_COMMAND_ID]);
 				if(status) { 
 					controlError(inst, status);
 					break;
@@ -189,7 +205,7 @@ void StCoreTarget(StCoreTarget_typ *inst) {
 			/* Set motion parameters */
 			if(inst->SetMotionParameters && !GET_BIT(inst->Internal.PreviousCommand, CORE_COMMAND_MOTION)) {
 				/* Run and activate */
-				status = coreSetMotionParameters(inst->Internal.Select, 0, inst->Parameters.Motion.Velocity, inst->Parameters.Motion.Acceleration, (void*)inst, (coreCommandType**)&inst->Internal.pCommand);
+				status = coreSetMotionParameters(inst->Internal.Select, 0, inst->Parameters.Motion.Velocity, inst->Parameters.Motion.Acceleration, (void*)inst, &inst->Internal.Handle[CORE_COMMAND_MOTION]);
 				if(status) { 
 					controlError(inst, status);
 					break;
@@ -201,7 +217,7 @@ void StCoreTarget(StCoreTarget_typ *inst) {
 			/* Set mechanical parameters */
 			if(inst->SetMechanicalParameters && !GET_BIT(inst->Internal.PreviousCommand, CORE_COMMAND_MECHANICAL)) {
 				/* Run and activate */
-				status = coreSetMechanicalParameters(inst->Internal.Select, 0, inst->Parameters.Mechanical.ShelfWidth, inst->Parameters.Mechanical.CenterOffset, (void*)inst, (coreCommandType**)&inst->Internal.pCommand);
+				status = coreSetMechanicalParameters(inst->Internal.Select, 0, inst->Parameters.Mechanical.ShelfWidth, inst->Parameters.Mechanical.CenterOffset, (void*)inst, &inst->Internal.Handle[CORE_COMMAND_MECHANICAL]);
 				if(status) { 
 					controlError(inst, status);
 					break;
@@ -213,7 +229,7 @@ void StCoreTarget(StCoreTarget_typ *inst) {
 			/* Set mechanical parameters */
 			if(inst->SetControlParameters && !GET_BIT(inst->Internal.PreviousCommand, CORE_COMMAND_CONTROL)) {
 				/* Run and activate */
-				status = coreSetControlParameters(inst->Internal.Select, 0, inst->Parameters.Control.ControlGainSet, inst->Parameters.Control.MovingFilter, inst->Parameters.Control.StationaryFilter, (void*)inst, (coreCommandType**)&inst->Internal.pCommand);
+				status = coreSetControlParameters(inst->Internal.Select, 0, inst->Parameters.Control.ControlGainSet, inst->Parameters.Control.MovingFilter, inst->Parameters.Control.StationaryFilter, (void*)inst, &inst->Internal.Handle[CORE_COMMAND_CONTROL]);
 				if(status) { 
 					controlError(inst, status);
 					break;
@@ -225,7 +241,7 @@ void StCoreTarget(StCoreTarget_typ *inst) {
 			/* Release pallet */
 			if(inst->ReleasePallet && !GET_BIT(inst->Internal.PreviousCommand, CORE_COMMAND_RELEASE)) {
 				/* Run and activate */
-				status = coreReleasePallet(inst->Internal.Select, 0, inst->Parameters.Release.Direction, inst->Parameters.Release.DestinationTarget, (void*)inst, (coreCommandType**)&inst->Internal.pCommand);
+				status = coreReleasePallet(inst->Internal.Select, 0, inst->Parameters.Release.Direction, inst->Parameters.Release.DestinationTarget, (void*)inst, &inst->Internal.Handle[CORE_COMMAND_RELEASE]);
 				if(status) { 
 					controlError(inst, status);
 					break;
@@ -237,7 +253,7 @@ void StCoreTarget(StCoreTarget_typ *inst) {
 			/* Release target offset */
 			if(inst->ReleaseTargetOffset && !GET_BIT(inst->Internal.PreviousCommand, CORE_COMMAND_OFFSET)) {
 				/* Run and activate */
-				status = coreReleaseTargetOffset(inst->Internal.Select, 0, inst->Parameters.Release.Direction, inst->Parameters.Release.DestinationTarget, inst->Parameters.Release.Offset, (void*)inst, (coreCommandType**)&inst->Internal.pCommand);
+				status = coreReleaseTargetOffset(inst->Internal.Select, 0, inst->Parameters.Release.Direction, inst->Parameters.Release.DestinationTarget, inst->Parameters.Release.Offset, (void*)inst, &inst->Internal.Handle[CORE_COMMAND_OFFSET]);
 				if(status) { 
 					controlError(inst, status);
 					break;
@@ -249,7 +265,7 @@ void StCoreTarget(StCoreTarget_typ *inst) {
 			/* Release incremental offset */
 			if(inst->ReleaseIncrementalOffset && !GET_BIT(inst->Internal.PreviousCommand, CORE_COMMAND_INCREMENT)) {
 				/* Run and activate */
-				status = coreReleaseIncrementalOffset(inst->Internal.Select, 0, inst->Parameters.Release.Offset, (void*)inst, (coreCommandType**)&inst->Internal.pCommand);
+				status = coreReleaseIncrementalOffset(inst->Internal.Select, 0, inst->Parameters.Release.Offset, (void*)inst, &inst->Internal.Handle[CORE_COMMAND_INCREMENT]);
 				if(status) { 
 					controlError(inst, status);
 					break;
@@ -261,7 +277,7 @@ void StCoreTarget(StCoreTarget_typ *inst) {
 			/* Continue move */
 			if(inst->ContinueMove && !GET_BIT(inst->Internal.PreviousCommand, CORE_COMMAND_CONTINUE)) {
 				/* Run and activate */
-				status = coreContinueMove(inst->Internal.Select, 0, (void*)inst, (coreCommandType**)&inst->Internal.pCommand);
+				status = coreContinueMove(inst->Internal.Select, 0, (void*)inst, &inst->Internal.Handle[CORE_COMMAND_CONTINUE]);
 				if(status) { 
 					controlError(inst, status);
 					break;
@@ -273,63 +289,68 @@ void StCoreTarget(StCoreTarget_typ *inst) {
 			/* Record command inputs */
 			recordInput(inst, &input);
 			
-			/* Monitor active command */
-			if(inst->Busy || inst->Acknowledged) {
+			/* Monitor active commands, each command input is tracked with its own request */
+			for(select = CORE_COMMAND_RELEASE; select < CORE_COMMAND_SELECT_COUNT; select++) {
+				pCommand = &inst->Command[select];
+				if(!pCommand->Busy && !pCommand->Acknowledged)
+					continue;
+				
 				/* Clear if user resets input */
-				if(!GET_BIT(input, inst->Internal.CommandSelect))
-					resetCommand(inst);
+				if(!GET_BIT(input, select)) {
+					resetCommand(inst, select);
+					continue;
+				}
 				
-				/* Monitor buffered command address */
-				else if(inst->Internal.pCommand != 0) { 
-					if(!inst->Acknowledged) { /* Command request acknowledged */
-						pCommand = (coreCommandType*)inst->Internal.pCommand;
-						if(pCommand->pInstance == inst) { /* Buffered command matches this instance */
-							if(GET_BIT(pCommand->status, CORE_COMMAND_DONE)) {
-								if(GET_BIT(pCommand->status, CORE_COMMAND_ERROR)) {
-									args.i[0] = inst->Internal.Select;
-									logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_COMMAND), "StCoreTarget target %i command error", &args);
-									resetOutput(inst);
-									inst->Error = true;
-									inst->StatusID = stCORE_ERROR_COMMAND;
-									inst->Internal.State = CORE_FUNCTION_ERROR;
-									break;
-								}
-								else {
-									/* Report acknowledged to user */
-									inst->Busy = false;
-									inst->Acknowledged = true;
-									inst->Internal.pCommand = 0; /* No further need to monitor buffered command address */
-								}
-							}
-						}
-						else { 
-							/* Error if the instance tracking does not match */
-							args.i[0] = inst->Internal.Select;
-							logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_ACKNOWLEDGE), "StCoreTarget target %i command cannot be acknowledged", &args);
-							resetOutput(inst);
-							inst->Error = true;
-							inst->StatusID = stCORE_ERROR_ACKNOWLEDGE;
-							inst->Internal.State = CORE_FUNCTION_ERROR;
-							break;
-							
-						} /* Instance matches buffered command? */
-					} /* Command request acknowledged? */
-					
-					/* Wait here while acknowledged for user command to reset */
-					
-				} /* Non-zero buffered command address? */
+				/* Wait here while acknowledged for user command to reset */
+				if(pCommand->Acknowledged)
+					continue;
 				
-				/* Error if buffered command address was not shared */
-				else if(!inst->Acknowledged) {
+				/* Error if the command was reused before its completion was seen */
+				if(!coreCommandStatus(inst->Internal.Handle[select], &commandStatus)) { /* Handle still refers to this instance's request */
 					args.i[0] = inst->Internal.Select;
-					logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_ACKNOWLEDGE), "StCoreTarget target %i command cannot be acknowledged", &args);
+					args.i[1] = select;
+					logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_ACKNOWLEDGE), "StCoreTarget target %i command %i cannot be acknowledged", &args);
 					resetOutput(inst);
 					inst->Error = true;
 					inst->StatusID = stCORE_ERROR_ACKNOWLEDGE;
 					inst->Internal.State = CORE_FUNCTION_ERROR;
 					break;
 				}
+				
+				if(!GET_BIT(commandStatus, CORE_COMMAND_DONE))
+					continue;
+				
+				if(GET_BIT(commandStatus, CORE_COMMAND_ERROR)) {
+					args.i[0] = inst->Internal.Select;
+					args.i[1] = select;
+					logMessage(CORE_LOG_SEVERITY_ERROR, coreLogCode(stCORE_ERROR_COMMAND), "StCoreTarget target %i command %i error", &args);
+					resetOutput(inst);
+					inst->Error = true;
+					inst->StatusID = stCORE_ERROR_COMMAND;
+					inst->Command[select].Error = true; /* Identify the failed command */
+					inst->Internal.State = CORE_FUNCTION_ERROR;
+					break;
+				}
+				
+				/* Report acknowledged to user, noting a command replaced by a newer request or cancelled before it was sent */
+				pCommand->Busy = false;
+				pCommand->Acknowledged = true;
+				pCommand->Superseded = GET_BIT(commandStatus, CORE_COMMAND_SUPERSEDED);
+				pCommand->Cancelled = GET_BIT(commandStatus, CORE_COMMAND_CANCELLED);
+				inst->Internal.Handle[select] = 0; /* No further need to monitor the command */
 			}
+			if(inst->Internal.State == CORE_FUNCTION_ERROR)
+				break;
+			
+			/* Busy while any command executes, acknowledged once every active command is acknowledged */
+			inst->Busy = false;
+			inst->Acknowledged = false;
+			for(select = CORE_COMMAND_RELEASE; select < CORE_COMMAND_SELECT_COUNT; select++) {
+				inst->Busy |= inst->Command[select].Busy;
+				inst->Acknowledged |= inst->Command[select].Acknowledged;
+			}
+			if(inst->Busy)
+				inst->Acknowledged = false;
 			
 			/******
 			 Status
@@ -400,9 +421,9 @@ void resetOutput(StCoreTarget_typ *inst) {
 	memset(&inst->Info, 0, sizeof(inst->Info));
 	inst->Busy = false;
 	inst->Acknowledged = false;
+	memset(&inst->Command, 0, sizeof(inst->Command));
 	inst->Internal.Select = 0;
-	inst->Internal.CommandSelect = 0;
-	inst->Internal.pCommand = 0;
+	memset(&inst->Internal.Handle, 0, sizeof(inst->Internal.Handle));
 	/* Do not clear state or previous value storage */
 }
 
@@ -413,16 +434,22 @@ void coreAssign16(unsigned short *pInteger, unsigned char bit, unsigned char val
 }
 
 /* Clear function block command data */
-void resetCommand(StCoreTarget_typ *inst) {
-	inst->Busy = false;
-	inst->Acknowledged = false;
-	inst->Internal.CommandSelect = 0;
-	inst->Internal.pCommand = 0;
+void resetCommand(StCoreTarget_typ *inst, unsigned char select) {
+	inst->Command[select].Busy = false;
+	inst->Command[select].Acknowledged = false;
+	inst->Command[select].Error = false;
+	inst->Command[select].Superseded = false;
+	inst->Command[select].Cancelled = false;
+	inst->Internal.Handle[select] = 0;
 }
 
-/* Set command selection and statuses when activated */
+/* Set command statuses when activated, the handle is written by the request */
 void activateCommand(StCoreTarget_typ *inst, unsigned char select) {
-	inst->Internal.CommandSelect = select;
+	inst->Command[select].Busy = true;
+	inst->Command[select].Acknowledged = false;
+	inst->Command[select].Error = false;
+	inst->Command[select].Superseded = false;
+	inst->Command[select].Cancelled = false;
 	inst->Busy = true;
 	inst->Acknowledged = false;
 }
@@ -0,0 +1,82 @@
+/*******************************************************************************
+ * File: StCore\Telemetry.c
+ * Author: agent
+ * Date: 2026-10-17
+*******************************************************************************/
+
+#include "Main.h"
+
+/* Read section parameters round-robin within the per-cycle read budget */
+void coreSectionTelemetry(void) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.telemetry (w)
+	   core.interface
+	   core.sectionAddress
+	   core.options
+	   core.cycleCount
+	   core.ready
+	   core.error
+	************************************************/
+	
+	/* Declare local variables */
+	coreTelemetryType *pTelemetry = &core.telemetry;
+	coreTelemetryEntryType *pEntry;
+	unsigned char section, reads;
+	
+	/* Do not read until parameters are saved */
+	if(core.error || !core.ready || core.interface.sectionCount == 0)
+		return;
+	
+	for(reads = 0; reads < core.options.Telemetry.ReadBudget; reads++) {
+		/* Restart if the section count is reduced */
+		if(pTelemetry->section >= core.interface.sectionCount || pTelemetry->section >= CORE_SECTION_MAX) {
+			pTelemetry->section = 0;
+			pTelemetry->step = 0;
+		}
+		
+		pEntry = &pTelemetry->entry[pTelemetry->section];
+		section = core.sectionAddress[pTelemetry->section];
+		
+		switch(pTelemetry->step) {
+			case CORE_TELEMETRY_WARNINGS:
+				SuperTrakServChanRead(section, stPAR_SECTION_FAULTS_ACTIVE, 1, 1, (unsigned long)&pEntry->warnings, sizeof(pEntry->warnings));
+				break;
+			
+			case CORE_TELEMETRY_FAULTS:
+				SuperTrakServChanRead(section, stPAR_SECTION_FAULTS_ACTIVE, 0, 1, (unsigned long)&pEntry->faults, sizeof(pEntry->faults));
+				break;
+			
+			case CORE_TELEMETRY_PALLET_COUNT:
+				SuperTrakServChanRead(section, stPAR_SECTION_PALLET_COUNT, 0, 1, (unsigned long)&pEntry->palletCount, sizeof(pEntry->palletCount));
+				break;
+			
+			case CORE_TELEMETRY_LOAD_POWER:
+				SuperTrakServChanRead(section, stPAR_SECTION_LOAD_POWER, 0, 1, (unsigned long)&pEntry->loadPower, sizeof(pEntry->loadPower));
+				break;
+			
+			case CORE_TELEMETRY_PEAK_POWER:
+				SuperTrakServChanRead(section, stPAR_SECTION_PEAK_POWER, 0, 1, (unsigned long)&pEntry->peakPower, sizeof(pEntry->peakPower));
+				break;
+			
+			case CORE_TELEMETRY_AVERAGE_POWER:
+				SuperTrakServChanRead(section, 1393, 0, 1, (unsigned long)&pEntry->averagePower, sizeof(pEntry->averagePower));
+				break;
+			
+			default:
+				SuperTrakServChanRead(section, stPAR_HARDWARE_SENSORS, 0, CORE_SECTION_SENSOR_MAX, (unsigned long)&pEntry->sensors, sizeof(pEntry->sensors));
+				break;
+		}
+		
+		/* Stamp the entry when all reads complete and move to the next section */
+		if(++pTelemetry->step >= CORE_TELEMETRY_STEP_COUNT) {
+			pEntry->cycle = core.cycleCount;
+			pEntry->valid = true;
+			pTelemetry->step = 0;
+			pTelemetry->section++;
+		}
+	}
+	
+} /* End function */
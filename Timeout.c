@@ -0,0 +1,147 @@
+/*******************************************************************************
+ * File: StCore\Timeout.c
+ * Author: agent
+ * Date: 2026-10-17
+*******************************************************************************/
+
+#include "Main.h"
+
+/* Prototypes */
+static void startDeadline(unsigned long *pWheel, unsigned long words, unsigned long *pDeadline, unsigned long item, unsigned long cycles);
+static void cancelDeadline(unsigned long *pWheel, unsigned long words, unsigned long *pDeadline, unsigned long item);
+static void expireDeadlines(unsigned long *pWheel, unsigned long words, unsigned long *pDeadline, unsigned long *pExpired);
+
+/* Upper limit of each response time bucket in cycles, the last bucket has no limit */
+static const unsigned long bucketLimit[CORE_COMMAND_LATENCY_BUCKET_COUNT - 1] = {1, 2, 3, 4, 6, 8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072};
+
+/* Add a response time to the rolling distribution of the command and derive its timeout */
+void coreCommandLatency(coreCommandSelectEnum select, unsigned long elapsed) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.commandTimeouts (w)
+	   core.options
+	************************************************/
+	
+	/* Declare local variables */
+	coreCommandEstimateType *pEstimate = &core.commandTimeouts.estimate[select];
+	StCoreCommandTimeoutType *pLimit = &core.options.Command.Timeout[select];
+	unsigned long cycles, sum, threshold, floor, ceiling;
+	unsigned char i;
+	
+	/* Find the bucket */
+	cycles = (elapsed + CORE_CYCLE_TIME - 1) / CORE_CYCLE_TIME;
+	for(i = 0; i < CORE_COMMAND_LATENCY_BUCKET_COUNT - 1; i++) {
+		if(cycles <= bucketLimit[i])
+			break;
+	}
+	pEstimate->histogram[i]++;
+	pEstimate->count++;
+	
+	/* Halve the distribution so recent responses outweigh old ones */
+	if(pEstimate->count >= CORE_COMMAND_LATENCY_WINDOW) {
+		pEstimate->count = 0;
+		for(i = 0; i < CORE_COMMAND_LATENCY_BUCKET_COUNT; i++) {
+			pEstimate->histogram[i] /= 2;
+			pEstimate->count += pEstimate->histogram[i];
+		}
+	}
+	
+	if(pEstimate->count < CORE_COMMAND_LATENCY_SAMPLES)
+		return;
+	
+	/* Upper limit of the 99th percentile bucket, the last bucket uses the ceiling */
+	threshold = pEstimate->count - pEstimate->count / 100;
+	sum = 0;
+	for(i = 0; i < CORE_COMMAND_LATENCY_BUCKET_COUNT - 1; i++) {
+		sum += pEstimate->histogram[i];
+		if(sum >= threshold)
+			break;
+	}
+	
+	floor = pLimit->Floor * 1000 / CORE_CYCLE_TIME;
+	ceiling = pLimit->Ceiling * 1000 / CORE_CYCLE_TIME;
+	if(i == CORE_COMMAND_LATENCY_BUCKET_COUNT - 1)
+		pEstimate->timeout = ceiling;
+	else
+		pEstimate->timeout = MIN(MAX((unsigned long)(bucketLimit[i] * pLimit->Factor), floor), ceiling);
+	
+} /* End function */
+
+/* Get the timeout of the command in cycles */
+unsigned long coreCommandTimeout(coreCommandSelectEnum select) {
+	
+	/* The ceiling applies until enough responses are observed */
+	if(core.commandTimeouts.estimate[select].count < CORE_COMMAND_LATENCY_SAMPLES && core.commandTimeouts.estimate[select].timeout == 0)
+		return core.options.Command.Timeout[select].Ceiling * 1000 / CORE_CYCLE_TIME;
+	
+	return core.commandTimeouts.estimate[select].timeout;
+}
+
+/* Start the deadline of the command written to the channel */
+void coreDeadlineStartChannel(unsigned char channel, coreCommandSelectEnum select) {
+	startDeadline(core.commandTimeouts.wheelChannels[0], BITMAP_WORDS(CORE_COMMAND_MAX), core.commandTimeouts.channel, channel, coreCommandTimeout(select));
+}
+
+/* Cancel the deadline of the command on the channel */
+void coreDeadlineCancelChannel(unsigned char channel) {
+	cancelDeadline(core.commandTimeouts.wheelChannels[0], BITMAP_WORDS(CORE_COMMAND_MAX), core.commandTimeouts.channel, channel);
+}
+
+/* Start the deadline of the target's simple release, target 1 is index 0 */
+void coreDeadlineStartTarget(unsigned char index) {
+	startDeadline(core.commandTimeouts.wheelTargets[0], BITMAP_WORDS(CORE_TARGET_MAX), core.commandTimeouts.target, index, coreCommandTimeout(CORE_COMMAND_SIMPLE));
+}
+
+/* Cancel the deadline of the target's simple release */
+void coreDeadlineCancelTarget(unsigned char index) {
+	cancelDeadline(core.commandTimeouts.wheelTargets[0], BITMAP_WORDS(CORE_TARGET_MAX), core.commandTimeouts.target, index);
+}
+
+/* Take the channels and targets whose deadline is this cycle */
+void coreDeadlineExpired(unsigned long *pChannels, unsigned long *pTargets) {
+	
+	/************************************************
+	 Dependencies:
+	  Global:
+	   core.commandTimeouts (w)
+	   core.cycleCount
+	************************************************/
+	
+	memset(pChannels, 0, sizeof(unsigned long) * BITMAP_WORDS(CORE_COMMAND_MAX));
+	memset(pTargets, 0, sizeof(unsigned long) * BITMAP_WORDS(CORE_TARGET_MAX));
+	expireDeadlines(core.commandTimeouts.wheelChannels[0], BITMAP_WORDS(CORE_COMMAND_MAX), core.commandTimeouts.channel, pChannels);
+	expireDeadlines(core.commandTimeouts.wheelTargets[0], BITMAP_WORDS(CORE_TARGET_MAX), core.commandTimeouts.target, pTargets);
+	
+} /* End function */
+
+/* Record the deadline and mark the item in its wheel slot */
+void startDeadline(unsigned long *pWheel, unsigned long words, unsigned long *pDeadline, unsigned long item, unsigned long cycles) {
+	pDeadline[item] = core.cycleCount + MAX(cycles, 1);
+	SET_BITMAP(pWheel + (pDeadline[item] % CORE_COMMAND_WHEEL_SIZE) * words, item);
+}
+
+/* Remove the item from its wheel slot */
+void cancelDeadline(unsigned long *pWheel, unsigned long words, unsigned long *pDeadline, unsigned long item) {
+	CLEAR_BITMAP(pWheel + (pDeadline[item] % CORE_COMMAND_WHEEL_SIZE) * words, item);
+}
+
+/* Move items of this cycle's wheel slot that are due to the expired bitmap, later laps stay in the slot */
+void expireDeadlines(unsigned long *pWheel, unsigned long words, unsigned long *pDeadline, unsigned long *pExpired) {
+	
+	/* Declare local variables */
+	unsigned long *pSlot = pWheel + (core.cycleCount % CORE_COMMAND_WHEEL_SIZE) * words;
+	unsigned long visit[BITMAP_WORDS(CORE_TARGET_MAX)]; /* Large enough for channels or targets */
+	long item;
+	
+	/* Visit each marked item once */
+	memcpy(visit, pSlot, sizeof(unsigned long) * words);
+	while((item = coreBitmapFind(visit, words * CORE_BITMAP_WORD_BITS, 0)) >= 0) {
+		CLEAR_BITMAP(visit, item);
+		if((long)(pDeadline[item] - core.cycleCount) <= 0) {
+			CLEAR_BITMAP(pSlot, item);
+			SET_BITMAP(pExpired, item);
+		}
+	}
+}